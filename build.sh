@@ -4,4 +4,22 @@ set -xe
 
 mkdir -p target
 
-gcc -Wall -Wextra -Wconversion -pedantic -g src/*.c -Isrc/ -o target/mini-a-b
+# EXTRA_CFLAGS="-DSEARCH_STATS -DSEARCH_TRACE" ./build.sh bench turns on search instrumentation
+CFLAGS="-Wall -Wextra -Wconversion -pedantic -g $EXTRA_CFLAGS"
+ENGINE_SOURCES="src/arena.c src/chess.c src/memory.c src/book.c src/search.c src/stats.c src/selfplay.c src/dataset.c src/attacks.c"
+LIBS="-lm -pthread"
+
+# ./build.sh bench [--json <file>] builds an optimized bench and runs it
+# ./build.sh match [options] does the same with the self-play match runner
+if [ "$1" = "bench" ] || [ "$1" = "match" ]; then
+    TOOL="$1"
+    shift
+    gcc $CFLAGS -O2 $ENGINE_SOURCES src/$TOOL.c -Isrc/ $LIBS -o target/$TOOL
+    ./target/$TOOL "$@"
+    exit 0
+fi
+
+gcc $CFLAGS $ENGINE_SOURCES src/tests.c -Isrc/ $LIBS -o target/mini-a-b
+gcc $CFLAGS $ENGINE_SOURCES src/book_builder.c -Isrc/ $LIBS -o target/book_builder
+gcc $CFLAGS $ENGINE_SOURCES src/bench.c -Isrc/ $LIBS -o target/bench
+gcc $CFLAGS $ENGINE_SOURCES src/match.c -Isrc/ $LIBS -o target/match
@@ -0,0 +1,57 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stddef.h>
+
+#include "arena.h"
+
+
+void init_arena(Arena* arena, void* memory, size_t capacity)
+{
+    arena->memory = memory;
+    arena->capacity = capacity;
+    arena->used = 0;
+}
+
+
+// NULL once the arena is full, it never falls back to malloc
+void* arena_alloc(Arena* arena, size_t size)
+{
+    size_t start = (arena->used + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (start > arena->capacity || size > arena->capacity - start)
+        return NULL;
+    arena->used = start + size;
+    return arena->memory + start;
+}
+
+
+size_t get_arena_mark(Arena* arena)
+{
+    return arena->used;
+}
+
+
+// Everything allocated after the mark was taken is released
+void reset_arena(Arena* arena, size_t mark)
+{
+    arena->used = mark;
+}
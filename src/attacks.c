@@ -0,0 +1,326 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// Set-wise attack generation: every piece of a kind at once, sliders with
+// Kogge-Stone occluded fills. With -mavx2 four directions are filled at
+// the same time.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "attacks.h"
+
+
+#define ALL_SQUARES (0xFFFFFFFFFFFFFFFFULL)
+#define NOT_COLUMN_1 (~COLUMN_1_SQUARES)
+#define NOT_COLUMN_8 (~COLUMN_8_SQUARES)
+// h1 to a8 and a1 to h8
+#define DIAGONAL_SQUARES (0x8040201008040201ULL)
+#define ANTI_DIAGONAL_SQUARES (0x0102040810204080ULL)
+
+
+// Directions where the squares get bigger: up, left, up + left, up + right.
+// Masks drop whatever wrapped around to the other side of the board.
+static const uint64_t UP_SHIFTS[4] = { 8, 1, 9, 7 };
+static const uint64_t UP_MASKS[4] = { ALL_SQUARES, NOT_COLUMN_8, NOT_COLUMN_8, NOT_COLUMN_1 };
+// And where they get smaller: down, right, down + left, down + right
+static const uint64_t DOWN_SHIFTS[4] = { 8, 1, 7, 9 };
+static const uint64_t DOWN_MASKS[4] = { ALL_SQUARES, NOT_COLUMN_1, NOT_COLUMN_8, NOT_COLUMN_1 };
+
+
+// Attacks of all the sliders in one direction, stopping at the first
+// occupied square, which is included
+static uint64_t fill_up(uint64_t sliders, uint64_t empty_squares, uint64_t shift, uint64_t mask)
+{
+    empty_squares &= mask;
+    sliders |= empty_squares & (sliders << shift);
+    empty_squares &= empty_squares << shift;
+    sliders |= empty_squares & (sliders << (shift * 2));
+    empty_squares &= empty_squares << (shift * 2);
+    sliders |= empty_squares & (sliders << (shift * 4));
+    return (sliders << shift) & mask;
+}
+
+
+static uint64_t fill_down(uint64_t sliders, uint64_t empty_squares, uint64_t shift, uint64_t mask)
+{
+    empty_squares &= mask;
+    sliders |= empty_squares & (sliders >> shift);
+    empty_squares &= empty_squares >> shift;
+    sliders |= empty_squares & (sliders >> (shift * 2));
+    empty_squares &= empty_squares >> (shift * 2);
+    sliders |= empty_squares & (sliders >> (shift * 4));
+    return (sliders >> shift) & mask;
+}
+
+
+#ifdef __AVX2__
+static __m256i fill_up_x4(__m256i sliders, __m256i empty_squares, __m256i shifts, __m256i masks)
+{
+    __m256i shifts_2 = _mm256_add_epi64(shifts, shifts);
+    __m256i shifts_4 = _mm256_add_epi64(shifts_2, shifts_2);
+    empty_squares = _mm256_and_si256(empty_squares, masks);
+    sliders = _mm256_or_si256(sliders, _mm256_and_si256(empty_squares, _mm256_sllv_epi64(sliders, shifts)));
+    empty_squares = _mm256_and_si256(empty_squares, _mm256_sllv_epi64(empty_squares, shifts));
+    sliders = _mm256_or_si256(sliders, _mm256_and_si256(empty_squares, _mm256_sllv_epi64(sliders, shifts_2)));
+    empty_squares = _mm256_and_si256(empty_squares, _mm256_sllv_epi64(empty_squares, shifts_2));
+    sliders = _mm256_or_si256(sliders, _mm256_and_si256(empty_squares, _mm256_sllv_epi64(sliders, shifts_4)));
+    return _mm256_and_si256(_mm256_sllv_epi64(sliders, shifts), masks);
+}
+
+
+static __m256i fill_down_x4(__m256i sliders, __m256i empty_squares, __m256i shifts, __m256i masks)
+{
+    __m256i shifts_2 = _mm256_add_epi64(shifts, shifts);
+    __m256i shifts_4 = _mm256_add_epi64(shifts_2, shifts_2);
+    empty_squares = _mm256_and_si256(empty_squares, masks);
+    sliders = _mm256_or_si256(sliders, _mm256_and_si256(empty_squares, _mm256_srlv_epi64(sliders, shifts)));
+    empty_squares = _mm256_and_si256(empty_squares, _mm256_srlv_epi64(empty_squares, shifts));
+    sliders = _mm256_or_si256(sliders, _mm256_and_si256(empty_squares, _mm256_srlv_epi64(sliders, shifts_2)));
+    empty_squares = _mm256_and_si256(empty_squares, _mm256_srlv_epi64(empty_squares, shifts_2));
+    sliders = _mm256_or_si256(sliders, _mm256_and_si256(empty_squares, _mm256_srlv_epi64(sliders, shifts_4)));
+    return _mm256_and_si256(_mm256_srlv_epi64(sliders, shifts), masks);
+}
+#endif
+
+
+// The attacks in all eight directions, one set per direction: up, left,
+// up + left, up + right and then the opposite ones. Directions 0, 1, 4 and
+// 5 are orthogonal and the rest diagonal, each takes its sliders from
+// sliders[direction % 4].
+static void fill_directions(uint64_t sliders[4], uint64_t empty_squares, uint64_t directions[8])
+{
+#ifdef __AVX2__
+    __m256i empty = _mm256_set1_epi64x((long long) empty_squares);
+    __m256i up = fill_up_x4(_mm256_loadu_si256((const __m256i*) sliders), empty,
+                            _mm256_loadu_si256((const __m256i*) UP_SHIFTS), _mm256_loadu_si256((const __m256i*) UP_MASKS));
+    __m256i down = fill_down_x4(_mm256_loadu_si256((const __m256i*) sliders), empty,
+                                _mm256_loadu_si256((const __m256i*) DOWN_SHIFTS), _mm256_loadu_si256((const __m256i*) DOWN_MASKS));
+    _mm256_storeu_si256((__m256i*) directions, up);
+    _mm256_storeu_si256((__m256i*) (directions + 4), down);
+#else
+    for (size_t i = 0; i < 4; ++i) {
+        directions[i] = fill_up(sliders[i], empty_squares, UP_SHIFTS[i], UP_MASKS[i]);
+        directions[i + 4] = fill_down(sliders[i], empty_squares, DOWN_SHIFTS[i], DOWN_MASKS[i]);
+    }
+#endif
+}
+
+
+uint64_t get_pawns_attacks(uint64_t pawns, bool turn)
+{
+    if (turn == WHITE_TURN)
+        return ((pawns << 9) & NOT_COLUMN_8) | ((pawns << 7) & NOT_COLUMN_1);
+    return ((pawns >> 7) & NOT_COLUMN_8) | ((pawns >> 9) & NOT_COLUMN_1);
+}
+
+
+// One set per jump, so that two knights reaching the same square show up
+static void get_knights_jumps(uint64_t knights, uint64_t jumps[8])
+{
+    uint64_t left_1 = (knights << 1) & NOT_COLUMN_8;
+    uint64_t left_2 = (left_1 << 1) & NOT_COLUMN_8;
+    uint64_t right_1 = (knights >> 1) & NOT_COLUMN_1;
+    uint64_t right_2 = (right_1 >> 1) & NOT_COLUMN_1;
+    jumps[0] = left_1 << 16;
+    jumps[1] = right_1 << 16;
+    jumps[2] = left_1 >> 16;
+    jumps[3] = right_1 >> 16;
+    jumps[4] = left_2 << 8;
+    jumps[5] = right_2 << 8;
+    jumps[6] = left_2 >> 8;
+    jumps[7] = right_2 >> 8;
+}
+
+
+uint64_t get_knights_attacks(uint64_t knights)
+{
+    uint64_t jumps[8];
+    get_knights_jumps(knights, jumps);
+    return jumps[0] | jumps[1] | jumps[2] | jumps[3] | jumps[4] | jumps[5] | jumps[6] | jumps[7];
+}
+
+
+uint64_t get_kings_attacks(uint64_t kings)
+{
+    uint64_t row = kings | ((kings << 1) & NOT_COLUMN_8) | ((kings >> 1) & NOT_COLUMN_1);
+    return (row | (row << 8) | (row >> 8)) & ~kings;
+}
+
+
+uint64_t get_rooks_attacks(uint64_t rooks, uint64_t empty_squares)
+{
+    return fill_up(rooks, empty_squares, UP_SHIFTS[0], UP_MASKS[0])
+        | fill_up(rooks, empty_squares, UP_SHIFTS[1], UP_MASKS[1])
+        | fill_down(rooks, empty_squares, DOWN_SHIFTS[0], DOWN_MASKS[0])
+        | fill_down(rooks, empty_squares, DOWN_SHIFTS[1], DOWN_MASKS[1]);
+}
+
+
+uint64_t get_bishops_attacks(uint64_t bishops, uint64_t empty_squares)
+{
+    return fill_up(bishops, empty_squares, UP_SHIFTS[2], UP_MASKS[2])
+        | fill_up(bishops, empty_squares, UP_SHIFTS[3], UP_MASKS[3])
+        | fill_down(bishops, empty_squares, DOWN_SHIFTS[2], DOWN_MASKS[2])
+        | fill_down(bishops, empty_squares, DOWN_SHIFTS[3], DOWN_MASKS[3]);
+}
+
+
+static void add_attacks(uint64_t attacks, uint64_t* attacked, uint64_t* double_attacked)
+{
+    *double_attacked |= *attacked & attacks;
+    *attacked |= attacks;
+}
+
+
+static void add_side_attacks(Board* board, bool turn, uint64_t empty_squares, AttackMaps* attack_maps)
+{
+    size_t first = turn == WHITE_TURN ? 0 : (N_PIECES / 2);
+    uint64_t* attacked = turn == WHITE_TURN ? &attack_maps->white_attacks : &attack_maps->black_attacks;
+    uint64_t* double_attacked = turn == WHITE_TURN ? &attack_maps->white_double_attacks : &attack_maps->black_double_attacks;
+    uint64_t* piece_attacks = attack_maps->piece_attacks + first;
+    uint64_t* pieces = board->pieces + first;
+    *attacked = 0ULL;
+    *double_attacked = 0ULL;
+
+    // Pawns, one side each
+    uint64_t pawns = pieces[W_PAWN_I];
+    uint64_t left_captures = turn == WHITE_TURN ? (pawns << 9) & NOT_COLUMN_8 : (pawns >> 7) & NOT_COLUMN_8;
+    uint64_t right_captures = turn == WHITE_TURN ? (pawns << 7) & NOT_COLUMN_1 : (pawns >> 9) & NOT_COLUMN_1;
+    piece_attacks[W_PAWN_I] = left_captures | right_captures;
+    add_attacks(left_captures, attacked, double_attacked);
+    add_attacks(right_captures, attacked, double_attacked);
+
+    uint64_t jumps[8];
+    get_knights_jumps(pieces[W_KNIGHT_I], jumps);
+    piece_attacks[W_KNIGHT_I] = 0ULL;
+    for (size_t i = 0; i < 8; ++i) {
+        piece_attacks[W_KNIGHT_I] |= jumps[i];
+        add_attacks(jumps[i], attacked, double_attacked);
+    }
+
+    piece_attacks[W_KING_I] = get_kings_attacks(pieces[W_KING_I]);
+    add_attacks(piece_attacks[W_KING_I], attacked, double_attacked);
+
+    // Rooks and bishops share the fills, queens get their own
+    uint64_t rooks = pieces[W_ROOK_I];
+    uint64_t bishops = pieces[W_BISHOP_I];
+    uint64_t queens = pieces[W_QUEEN_I];
+    uint64_t sliders[4] = { rooks, rooks, bishops, bishops };
+    uint64_t directions[8];
+    fill_directions(sliders, empty_squares, directions);
+    piece_attacks[W_ROOK_I] = directions[0] | directions[1] | directions[4] | directions[5];
+    piece_attacks[W_BISHOP_I] = directions[2] | directions[3] | directions[6] | directions[7];
+    for (size_t i = 0; i < 8; ++i) {
+        add_attacks(directions[i], attacked, double_attacked);
+    }
+
+    piece_attacks[W_QUEEN_I] = 0ULL;
+    if (queens != 0ULL) {
+        uint64_t queen_sliders[4] = { queens, queens, queens, queens };
+        fill_directions(queen_sliders, empty_squares, directions);
+        for (size_t i = 0; i < 8; ++i) {
+            piece_attacks[W_QUEEN_I] |= directions[i];
+            add_attacks(directions[i], attacked, double_attacked);
+        }
+    }
+}
+
+
+// Meant to be done once per node and shared by whatever needs it
+void compute_attack_maps(Board* board, AttackMaps* attack_maps)
+{
+    uint64_t empty_squares = ~get_all_occupied_squares(board);
+    add_side_attacks(board, WHITE_TURN, empty_squares, attack_maps);
+    add_side_attacks(board, BLACK_TURN, empty_squares, attack_maps);
+}
+
+
+// Whether the king of the given side is attacked
+bool is_king_attacked(Board* board, AttackMaps* attack_maps, bool turn)
+{
+    if (turn == WHITE_TURN)
+        return (board->pieces[W_KING_I] & attack_maps->black_attacks) != 0ULL;
+    return (board->pieces[B_KING_I] & attack_maps->white_attacks) != 0ULL;
+}
+
+
+// The row and column through a single square, ignoring blockers
+static uint64_t get_orthogonal_lines(uint64_t square)
+{
+    if (square == 0ULL)
+        return 0ULL;
+    unsigned int bit = (unsigned int) __builtin_ctzll(square);
+    return (0xFFULL << (bit & ~7U)) | (COLUMN_8_SQUARES << (bit & 7U));
+}
+
+
+// Both diagonals through a single square, ignoring blockers
+static uint64_t get_diagonal_lines(uint64_t square)
+{
+    if (square == 0ULL)
+        return 0ULL;
+    int row = __builtin_ctzll(square) / 8;
+    int col = __builtin_ctzll(square) % 8; // 0 is column 8
+    int diagonal = row - col;
+    int anti_diagonal = row + col - 7;
+    uint64_t lines = diagonal >= 0 ? DIAGONAL_SQUARES << (8 * diagonal) : DIAGONAL_SQUARES >> (-8 * diagonal);
+    lines |= anti_diagonal >= 0 ? ANTI_DIAGONAL_SQUARES << (8 * anti_diagonal) : ANTI_DIAGONAL_SQUARES >> (-8 * anti_diagonal);
+    return lines;
+}
+
+
+// Whether a piece of the given side attacks square. Looks only from the
+// square outwards, much cheaper than building the maps for a single question.
+bool is_square_attacked(Board* board, uint64_t square, bool turn)
+{
+    uint64_t* pieces = board->pieces + (turn == WHITE_TURN ? 0 : (N_PIECES / 2));
+    uint64_t empty_squares = ~get_all_occupied_squares(board);
+    // A pawn attacks square if a pawn of the other side there would attack it
+    if ((get_pawns_attacks(square, !turn) & pieces[W_PAWN_I]) != 0ULL)
+        return true;
+    if ((get_knights_attacks(square) & pieces[W_KNIGHT_I]) != 0ULL)
+        return true;
+    if ((get_kings_attacks(square) & pieces[W_KING_I]) != 0ULL)
+        return true;
+    uint64_t orthogonal = pieces[W_ROOK_I] | pieces[W_QUEEN_I];
+    uint64_t diagonal = pieces[W_BISHOP_I] | pieces[W_QUEEN_I];
+    if ((orthogonal & get_orthogonal_lines(square)) == 0ULL && (diagonal & get_diagonal_lines(square)) == 0ULL)
+        return false;
+    uint64_t sliders[4] = { square, square, square, square };
+    uint64_t directions[8];
+    fill_directions(sliders, empty_squares, directions);
+    return ((directions[0] | directions[1] | directions[4] | directions[5]) & orthogonal) != 0ULL
+        || ((directions[2] | directions[3] | directions[6] | directions[7]) & diagonal) != 0ULL;
+}
+
+
+// Whether the side not to move could take the king of the side to move
+bool is_in_check(Board* board)
+{
+    uint64_t king = board->pieces[board->turn == WHITE_TURN ? W_KING_I : B_KING_I];
+    return is_square_attacked(board, king, !board->turn);
+}
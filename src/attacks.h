@@ -0,0 +1,62 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "chess.h"
+
+
+/**
+ * Structs
+ */
+
+// Squares attacked by every piece of a side at once. Double attacks are
+// squares hit by at least two pieces, x-rays don't count.
+typedef struct {
+    uint64_t white_attacks;
+    uint64_t black_attacks;
+    uint64_t white_double_attacks;
+    uint64_t black_double_attacks;
+    uint64_t piece_attacks[N_PIECES]; // Indexed by PIECE_INDEX
+} AttackMaps;
+
+
+/**
+ * Functions
+ */
+
+uint64_t get_pawns_attacks(uint64_t pawns, bool turn);
+uint64_t get_knights_attacks(uint64_t knights);
+uint64_t get_kings_attacks(uint64_t kings);
+uint64_t get_rooks_attacks(uint64_t rooks, uint64_t empty_squares);
+uint64_t get_bishops_attacks(uint64_t bishops, uint64_t empty_squares);
+void compute_attack_maps(Board* board, AttackMaps* attack_maps);
+bool is_king_attacked(Board* board, AttackMaps* attack_maps, bool turn);
+bool is_square_attacked(Board* board, uint64_t square, bool turn);
+bool is_in_check(Board* board);
+
+
+#endif // ATTACKS_H
@@ -0,0 +1,412 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// Fixed benchmark suite. Every section runs over the same positions and
+// the node counts only depend on the engine, so the signature printed at
+// the end changes if and only if the engine's behaviour does.
+//
+// Usage: bench [--json <file>]  ("-" writes the JSON to stdout)
+//              [--trace <file>] (needs -DSEARCH_TRACE)
+//
+// Built with -DSEARCH_STATS it also prints the search counters.
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chess.h"
+#include "dataset.h"
+#include "search.h"
+
+
+#define MOVEGEN_ITERATIONS (2000)
+#define EVALUATION_ITERATIONS (200000)
+#define PACK_ITERATIONS (20000)
+#define PERFT_DEPTH (3)
+#define SEARCH_DEPTH (4)
+#define TRACE_CAPACITY (1 << 20)
+
+
+static const char* BENCH_POSITIONS[] = {
+    // Starting position and the usual perft positions
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - -",
+    // Openings
+    "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3",
+    "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6",
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq -",
+    "r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq -",
+    "rnbqkb1r/pppppppp/5n2/8/2PP4/8/PP2PPPP/RNBQKBNR b KQkq c3",
+    "rnbqk2r/pppp1ppp/4pn2/8/1bPP4/2N5/PP2PPPP/R1BQKBNR w KQkq -",
+    "rnbqkbnr/ppp1pppp/8/3p4/2PP4/8/PP2PPPP/RNBQKBNR b KQkq c3",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq -",
+    "rnbqkbnr/pp2pppp/3p4/2p5/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq -",
+    "rnbqkbnr/pppp1ppp/4p3/8/3PP3/8/PPP2PPP/RNBQKBNR b KQkq d3",
+    // Bratko-Kopec
+    "1k1r4/pp1b1R2/3q2pp/4p3/2B5/4Q3/PPP2B2/2K5 b - -",
+    "3r1k2/4npp1/1ppr3p/p6P/P2PPPP1/1NR5/5K2/2R5 w - -",
+    "2q1rr1k/3bbnnp/p2p1pp1/2pPp3/PpP1P1P1/1P2BNNP/2BQ1PRK/7R b - -",
+    "rnbqkb1r/p3pppp/1p6/2ppP3/3N4/2P5/PPP1QPPP/R1B1KB1R w KQkq -",
+    "r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w - -",
+    "2r3k1/pppR1pp1/4p3/4P1P1/5P2/1P4K1/P1P5/8 w - -",
+    "1nk1r1r1/pp2n1pp/4p3/q2pPp1N/b1pP1P2/B1P2R2/2P1B1PP/R2Q2K1 w - -",
+    "4b3/p3kp2/6p1/3pP2p/2pP1P2/4K1P1/P3N2P/8 w - -",
+    "2kr1bnr/pbpq4/2n1pp2/3p3p/3P1P1B/2N2N1Q/PPP3PP/2KR1B1R w - -",
+    "3rr1k1/pp3pp1/1qn2np1/8/3p4/PP1R1P2/2P1NQPP/R1B3K1 b - -",
+    "2r1nrk1/p2q1ppp/bp1p4/n1pPp3/P1P1P3/2PBB1N1/4QPPP/R4RK1 w - -",
+    "r3r1k1/ppqb1ppp/8/4p1NQ/8/2P5/PP3PPP/R3R1K1 b - -",
+    "r2q1rk1/4bppp/p2p4/2pP4/3pP3/3Q4/PP1B1PPP/R3R1K1 w - -",
+    "rnb2r1k/pp2p2p/2pp2p1/q2P1p2/8/1Pb2NP1/PB2PPBP/R2Q1RK1 w - -",
+    "2r3k1/1p2q1pp/2b1pr2/p1pp4/6Q1/1P1PP1R1/P1PN2PP/5RK1 w - -",
+    "r1bqkb1r/4npp1/p1p4p/1p1pP1B1/8/1B6/PPPN1PPP/R2Q1RK1 w kq -",
+    "r2q1rk1/1ppnbppp/p2p1nb1/3Pp3/2P1P1P1/2N2N1P/PPB1QP2/R1B2RK1 b - -",
+    "r1bq1rk1/pp2ppbp/2np2p1/2n5/P3PP2/N1P2N2/1PB3PP/R1B1QRK1 b - -",
+    "3rr3/2pq2pk/p2p1pnp/8/2QBPP2/1P6/P5PP/4RRK1 b - -",
+    "r4k2/pb2bp1r/1p1qp2p/3pNp2/3P1P2/2N3P1/PPP1Q2P/2KRR3 w - -",
+    "3rn2k/ppb2rpp/2ppqp2/5N2/2P1P3/1P5Q/PB3PPP/3RR1K1 w - -",
+    "2r2rk1/1bqnbpp1/1p1ppn1p/pP6/N1P1P3/P2B1N1P/1B2QPP1/R2R2K1 b - -",
+    "r1bqk2r/pp2bppp/2p5/3pP3/P2Q1P2/2N1B3/1PP3PP/R4RK1 b kq -",
+    "r2qnrnk/p2b2b1/1p1p2pp/2pPpp2/1PP1P3/PRNBB3/3QNPPP/5RK1 w - -",
+    // Endgames
+    "8/8/8/8/8/8/6k1/4K2R w K -",
+    "8/8/1k6/8/8/8/6K1/3Q4 w - -",
+    "8/5k2/8/8/8/8/3PK3/8 w - -",
+    "8/8/4k3/3p4/3P4/4K3/8/8 w - -",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - -",
+    "8/p4pk1/1p4p1/2p5/2P5/1P4P1/P4PK1/8 w - -",
+    "2k5/8/8/8/8/8/8/2KR4 b - -",
+    "8/8/3k4/8/2B5/2N5/8/4K3 w - -",
+    "4r1k1/5ppp/8/8/8/8/5PPP/1R4K1 b - -",
+    "8/3k4/8/2n5/8/3K4/3P4/8 b - -",
+};
+
+#define N_BENCH_POSITIONS (sizeof(BENCH_POSITIONS) / sizeof(BENCH_POSITIONS[0]))
+
+
+typedef struct {
+    const char* name;
+    const char* unit; // What per_second counts
+    uint64_t count;     // Calls or nodes
+    uint64_t signature; // Results that only depend on the engine
+    double wall_time;
+    double per_second;
+    double position_times[N_BENCH_POSITIONS];
+    double p50;
+    double p90;
+    double p99;
+} BenchSection;
+
+
+static int compare_doubles(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+
+// Nearest rank percentile of the per position times, in microseconds
+static double get_percentile(double* sorted_times, size_t count, double percentile)
+{
+    size_t rank = (size_t) (percentile / 100.0 * (double) count + 0.5);
+    if (rank < 1)
+        rank = 1;
+    if (rank > count)
+        rank = count;
+    return sorted_times[rank - 1] * 1e6;
+}
+
+
+static void finish_section(BenchSection* section)
+{
+    section->wall_time = 0.0;
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        section->wall_time += section->position_times[i];
+    }
+    section->per_second = section->wall_time > 0.0 ? (double) section->count / section->wall_time : 0.0;
+
+    double sorted_times[N_BENCH_POSITIONS];
+    memcpy(sorted_times, section->position_times, sizeof(sorted_times));
+    qsort(sorted_times, N_BENCH_POSITIONS, sizeof(double), compare_doubles);
+    section->p50 = get_percentile(sorted_times, N_BENCH_POSITIONS, 50.0);
+    section->p90 = get_percentile(sorted_times, N_BENCH_POSITIONS, 90.0);
+    section->p99 = get_percentile(sorted_times, N_BENCH_POSITIONS, 99.0);
+}
+
+
+static void fail(const char* section)
+{
+    fprintf(stderr, "Error: Out of memory in %s\n", section);
+    exit(1);
+}
+
+
+static void bench_movegen(Board** boards, BenchSection* section, ThreadMemory* memory)
+{
+    section->name = "movegen";
+    section->unit = "calls";
+    section->count = 0;
+    section->signature = 0;
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        double start = get_time();
+        for (size_t j = 0; j < MOVEGEN_ITERATIONS; ++j) {
+            size_t mark = get_arena_mark(&memory->arena);
+            MoveArray* move_array = get_pseudomoves_from_board_in(&memory->arena, boards[i]);
+            if (move_array == NULL)
+                fail(section->name);
+            if (j == 0)
+                section->signature += move_array->count;
+            reset_arena(&memory->arena, mark);
+        }
+        section->position_times[i] = get_time() - start;
+        section->count += MOVEGEN_ITERATIONS;
+    }
+}
+
+
+static void bench_perft(Board** boards, BenchSection* section, ThreadMemory* memory)
+{
+    section->name = "perft";
+    section->unit = "nodes";
+    section->count = 0;
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        double start = get_time();
+        if (perft(boards[i], PERFT_DEPTH, memory, &section->count) != ENGINE_OK)
+            fail(section->name);
+        section->position_times[i] = get_time() - start;
+    }
+    section->signature = section->count;
+}
+
+
+static void bench_evaluation(Board** boards, BenchSection* section)
+{
+    section->name = "evaluation";
+    section->unit = "evaluations";
+    section->count = 0;
+    section->signature = 0;
+    // volatile so the calls can't be hoisted out of the loop
+    volatile int evaluation = 0;
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        double start = get_time();
+        for (size_t j = 0; j < EVALUATION_ITERATIONS; ++j) {
+            evaluation = evaluate_board(boards[i]);
+        }
+        section->position_times[i] = get_time() - start;
+        section->count += EVALUATION_ITERATIONS;
+        section->signature += (uint64_t) ABS(evaluation);
+    }
+}
+
+
+// One pack and one unpack per iteration
+static void bench_pack(Board** boards, BenchSection* section, ThreadMemory* memory)
+{
+    section->name = "pack";
+    section->unit = "positions";
+    section->count = 0;
+    section->signature = 0;
+    Board* board = acquire_board(&memory->boards);
+    if (board == NULL)
+        fail(section->name);
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        PackedPosition packed;
+        int score = 0;
+        int result = 0;
+        double start = get_time();
+        for (size_t j = 0; j < PACK_ITERATIONS; ++j) {
+            // volatile so the round trips can't be folded into one
+            volatile int packed_score = (int) j;
+            pack_position(boards[i], packed_score, 0, &packed);
+            unpack_position(&packed, board, &score, &result);
+        }
+        section->position_times[i] = get_time() - start;
+        section->count += PACK_ITERATIONS;
+        bool same_position = memcmp(board->pieces, boards[i]->pieces, sizeof(uint64_t) * N_PIECES) == 0
+            && board->turn == boards[i]->turn
+            && board->castling_rights == boards[i]->castling_rights
+            && board->en_passant == boards[i]->en_passant
+            && board->en_passant_square == boards[i]->en_passant_square;
+        if (!same_position || score != PACK_ITERATIONS - 1 || result != 0) {
+            fprintf(stderr, "Error: %s doesn't survive packing\n", BENCH_POSITIONS[i]);
+            exit(1);
+        }
+        for (size_t j = 0; j < PACKED_POSITION_SIZE; ++j) {
+            section->signature += ((uint8_t*) &packed)[j];
+        }
+    }
+    release_board(&memory->boards, board);
+}
+
+
+// total collects the counters of every search and hands them its trace
+static void bench_search(Board** boards, BenchSection* section, Search* total)
+{
+    section->name = "search";
+    section->unit = "nodes";
+    section->count = 0;
+    section->signature = 0;
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        Search search = { 0 };
+        search.memory = total->memory;
+#ifdef SEARCH_TRACE
+        search.trace = total->trace;
+#endif
+        Move best_move;
+        double start = get_time();
+        int score = search_board(boards[i], SEARCH_DEPTH, &best_move, &search);
+        section->position_times[i] = get_time() - start;
+        if (search.error != ENGINE_OK)
+            fail(section->name);
+        section->count += search.nodes;
+        section->signature += search.nodes + (uint64_t) ABS(score);
+        total->nodes += search.nodes;
+#ifdef SEARCH_STATS
+        add_search_stats(&total->stats, &search.stats);
+#endif
+    }
+}
+
+
+static void write_json(FILE* file, BenchSection* sections, size_t n_sections, uint64_t signature, double total_time)
+{
+    fprintf(file, "{\n");
+    fprintf(file, "  \"positions\": %zu,\n", N_BENCH_POSITIONS);
+    fprintf(file, "  \"signature\": %llu,\n", (unsigned long long) signature);
+    fprintf(file, "  \"wall_time_s\": %.6f,\n", total_time);
+    fprintf(file, "  \"sections\": {\n");
+    for (size_t i = 0; i < n_sections; ++i) {
+        BenchSection* section = &sections[i];
+        fprintf(file, "    \"%s\": {\n", section->name);
+        fprintf(file, "      \"unit\": \"%s\",\n", section->unit);
+        fprintf(file, "      \"count\": %llu,\n", (unsigned long long) section->count);
+        fprintf(file, "      \"wall_time_s\": %.6f,\n", section->wall_time);
+        fprintf(file, "      \"per_second\": %.1f,\n", section->per_second);
+        fprintf(file, "      \"position_time_us\": { \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f }\n", section->p50, section->p90, section->p99);
+        fprintf(file, "    }%s\n", i + 1 < n_sections ? "," : "");
+    }
+    fprintf(file, "  }\n");
+    fprintf(file, "}\n");
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* json_path = NULL;
+    const char* trace_path = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+#ifdef SEARCH_TRACE
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+#endif
+        } else {
+            fprintf(stderr, "Usage: %s [--json <file>] [--trace <file>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    EngineMemory memory;
+    MemoryConfig config = get_memory_config(1, PERFT_DEPTH > SEARCH_DEPTH ? PERFT_DEPTH : SEARCH_DEPTH);
+    if (create_engine_memory(&memory, &config) != ENGINE_OK)
+        fail("setup");
+
+    Search total_search = { 0 };
+    total_search.memory = get_thread_memory(&memory, 0);
+#ifdef SEARCH_TRACE
+    if (trace_path != NULL) {
+        total_search.trace = create_search_trace(TRACE_CAPACITY);
+        if (total_search.trace == NULL)
+            fail("setup");
+    }
+#endif
+
+    Board* boards[N_BENCH_POSITIONS];
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        boards[i] = create_board_from_fen(BENCH_POSITIONS[i]);
+        if (boards[i] == NULL) {
+            fprintf(stderr, "Error: Invalid bench position %s\n", BENCH_POSITIONS[i]);
+            exit(1);
+        }
+    }
+
+    BenchSection sections[5];
+    size_t n_sections = sizeof(sections) / sizeof(sections[0]);
+    bench_movegen(boards, &sections[0], total_search.memory);
+    bench_perft(boards, &sections[1], total_search.memory);
+    bench_evaluation(boards, &sections[2]);
+    bench_search(boards, &sections[3], &total_search);
+    bench_pack(boards, &sections[4], total_search.memory);
+
+    uint64_t signature = 0;
+    double total_time = 0.0;
+    for (size_t i = 0; i < n_sections; ++i) {
+        finish_section(&sections[i]);
+        signature += sections[i].signature;
+        total_time += sections[i].wall_time;
+    }
+
+    FILE* output = json_path != NULL && strcmp(json_path, "-") == 0 ? stderr : stdout;
+    for (size_t i = 0; i < n_sections; ++i) {
+        BenchSection* section = &sections[i];
+        fprintf(output, "%-10s %12llu %-11s %8.3f s %14.0f %s/s  p50 %10.1f us  p90 %10.1f us  p99 %10.1f us\n",
+                section->name, (unsigned long long) section->count, section->unit, section->wall_time,
+                section->per_second, section->unit, section->p50, section->p90, section->p99);
+    }
+    fprintf(output, "Time: %.3f s\n", total_time);
+    fprintf(output, "Signature: %llu\n", (unsigned long long) signature);
+#ifdef SEARCH_STATS
+    print_search_stats(output, total_search.nodes, &total_search.stats);
+#endif
+#ifdef SEARCH_TRACE
+    if (total_search.trace != NULL) {
+        if (!dump_search_trace(total_search.trace, trace_path))
+            exit(1);
+        destroy_search_trace(total_search.trace);
+    }
+#else
+    (void) trace_path;
+#endif
+
+    if (json_path != NULL) {
+        FILE* file = strcmp(json_path, "-") == 0 ? stdout : fopen(json_path, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Error: Could not create %s\n", json_path);
+            exit(1);
+        }
+        write_json(file, sections, n_sections, signature, total_time);
+        if (file != stdout)
+            fclose(file);
+    }
+
+    for (size_t i = 0; i < N_BENCH_POSITIONS; ++i) {
+        destroy_board(boards[i]);
+    }
+    destroy_engine_memory(&memory);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "chess.h"
+
+
+/**
+ * Constants
+ */
+
+// Polyglot .bin layout: 16 bytes per entry, big endian, sorted by key
+#define BOOK_ENTRY_SIZE (16)
+#define MAX_BOOK_WEIGHT (0xFFFF)
+
+
+/**
+ * Structs
+ */
+
+typedef struct {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+    uint32_t learn;
+} BookEntry;
+
+
+// The file stays mapped until close_book, lookups never touch the file
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    size_t count;
+} Book;
+
+
+/**
+ * Functions
+ */
+
+uint64_t get_book_key(Board* board);
+uint16_t encode_book_move(Move* move);
+bool decode_book_move(Board* board, uint16_t book_move, Move* move);
+Book* open_book(const char* path);
+void close_book(Book* book);
+BookEntry get_book_entry(Book* book, size_t index);
+size_t find_book_entry(Book* book, uint64_t key);
+bool get_book_move(Book* book, Board* board, uint64_t* random_state, Move* move);
+void sort_book_entries(BookEntry* entries, size_t* count);
+bool write_book(const char* path, BookEntry* entries, size_t count);
+
+
+#endif // BOOK_H
@@ -0,0 +1,308 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// Builds a Polyglot style book out of EPD and PGN files.
+//
+// Every line gives a position and the moves played from it in its bm
+// operation, in SAN as standard EPD does. Coordinate notation is accepted
+// too:
+//
+//     rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - bm e4 d4;
+//     rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - bm e2e4;
+//
+// Promotions can't be stored yet and are skipped.
+//
+// Files ending in .pgn are read as PGN instead. The first --plies moves
+// of every game go into the book, starting from the FEN tag if there is
+// one. Comments, variations and NAGs are ignored, and a move that can't
+// be read ends that game for the book.
+//
+// Each time a move appears for a position its weight goes up by one.
+//
+// Usage: book_builder [--plies N] <output.bin> <input.epd|input.pgn>...
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "book.h"
+#include "chess.h"
+
+
+#define INITIAL_ENTRIES_CAPACITY (1024)
+#define MAX_EPD_LINE (1024)
+#define DEFAULT_BOOK_PLIES (16)
+
+
+typedef struct {
+    BookEntry* entries;
+    size_t capacity;
+    size_t count;
+} BookEntryArray;
+
+
+// The PGN game being read, its movetext can span many lines
+typedef struct {
+    Board* board; // NULL between games
+    char fen[MAX_EPD_LINE];
+    size_t ply;
+    size_t max_plies;
+    bool skipping; // A move couldn't be read, the rest of the game is left out
+    bool in_comment;
+    size_t variation_depth;
+} PgnReader;
+
+
+bool insert_book_entry(BookEntryArray* arr, uint64_t key, uint16_t move)
+{
+    if (arr->count == arr->capacity) {
+        BookEntry* temp = (BookEntry*) realloc(arr->entries, sizeof(BookEntry) * arr->capacity * 2);
+        if (temp == NULL)
+            return false;
+        arr->entries = temp;
+        arr->capacity *= 2;
+    }
+    BookEntry* entry = &arr->entries[arr->count++];
+    entry->key = key;
+    entry->move = move;
+    entry->weight = 1;
+    entry->learn = 0;
+    return true;
+}
+
+
+// Returns false if memory runs out
+bool read_epd_line(BookEntryArray* arr, char* line)
+{
+    Board* board = create_board_from_fen(line);
+    if (board == NULL)
+        return true;
+
+    // Operations start after the four position fields
+    char* operations = line;
+    for (size_t i = 0; i < 4 && operations != NULL; ++i) {
+        operations = strchr(operations, ' ');
+        if (operations != NULL)
+            operations += 1;
+    }
+    char* best_moves = operations != NULL ? strstr(operations, "bm ") : NULL;
+    if (best_moves == NULL) {
+        destroy_board(board);
+        return true;
+    }
+
+    MoveArray* move_array = get_pseudomoves_from_board(board);
+    if (move_array == NULL) {
+        destroy_board(board);
+        return false;
+    }
+
+    uint64_t key = get_book_key(board);
+    bool result = true;
+    char* end = strchr(best_moves, ';');
+    if (end != NULL)
+        *end = '\0';
+    for (char* token = strtok(best_moves + 3, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n")) {
+        Move move;
+        if (!parse_san_move(board, token, move_array, &move) && (strlen(token) != 4 || !parse_move(board, token, &move))) {
+            fprintf(stderr, "Warning: Skipping move %s\n", token);
+            continue;
+        }
+        if (!insert_book_entry(arr, key, encode_book_move(&move))) {
+            result = false;
+            break;
+        }
+    }
+
+    destroy_move_array(move_array);
+    destroy_board(board);
+    return result;
+}
+
+
+static void end_pgn_game(PgnReader* reader)
+{
+    if (reader->board != NULL)
+        destroy_board(reader->board);
+    reader->board = NULL;
+    reader->fen[0] = '\0';
+}
+
+
+static bool is_pgn_result(const char* token)
+{
+    return strcmp(token, "1-0") == 0 || strcmp(token, "0-1") == 0 || strcmp(token, "1/2-1/2") == 0 || strcmp(token, "*") == 0;
+}
+
+
+// Returns false if memory runs out
+static bool read_pgn_move(BookEntryArray* arr, PgnReader* reader, char* token)
+{
+    // Move numbers can be glued to the move, as in 12.e4 or 12...e5
+    size_t digits = strspn(token, "0123456789");
+    if (digits > 0 && token[digits] == '.')
+        token += digits + strspn(token + digits, ".");
+    if (token[0] == '\0' || token[0] == '$')
+        return true;
+
+    if (reader->board == NULL) {
+        reader->board = reader->fen[0] != '\0' ? create_board_from_fen(reader->fen) : create_default_board();
+        reader->ply = 0;
+        reader->skipping = reader->board == NULL;
+        if (reader->board == NULL)
+            fprintf(stderr, "Warning: Skipping game with FEN %s\n", reader->fen);
+    }
+    if (reader->skipping || reader->ply >= reader->max_plies)
+        return true;
+
+    MoveArray* move_array = get_pseudomoves_from_board(reader->board);
+    if (move_array == NULL)
+        return false;
+    Move move;
+    bool found = parse_san_move(reader->board, token, move_array, &move);
+    destroy_move_array(move_array);
+    if (!found) {
+        fprintf(stderr, "Warning: Skipping the rest of a game from move %s\n", token);
+        reader->skipping = true;
+        return true;
+    }
+    if (!insert_book_entry(arr, get_book_key(reader->board), encode_book_move(&move)))
+        return false;
+    make_move(reader->board, &move);
+    reader->ply += 1;
+    return true;
+}
+
+
+// Returns false if memory runs out
+static bool read_pgn_line(BookEntryArray* arr, PgnReader* reader, char* line)
+{
+    if (!reader->in_comment && reader->variation_depth == 0 && line[0] == '[') {
+        // A tag after movetext means the last game had no result
+        end_pgn_game(reader);
+        char value[MAX_EPD_LINE];
+        if (sscanf(line, "[FEN \"%1023[^\"]\"]", value) == 1)
+            strcpy(reader->fen, value);
+        return true;
+    }
+
+    char* c = line;
+    while (*c != '\0') {
+        if (reader->in_comment) {
+            reader->in_comment = *c != '}';
+            c += 1;
+        } else if (*c == '{') {
+            reader->in_comment = true;
+            c += 1;
+        } else if (*c == ';') {
+            break;
+        } else if (*c == '(') {
+            reader->variation_depth += 1;
+            c += 1;
+        } else if (*c == ')') {
+            if (reader->variation_depth > 0)
+                reader->variation_depth -= 1;
+            c += 1;
+        } else if (strchr(" \t\r\n", *c) != NULL) {
+            c += 1;
+        } else {
+            char token[MAX_EPD_LINE];
+            size_t length = strcspn(c, " \t\r\n{}();");
+            memcpy(token, c, length);
+            token[length] = '\0';
+            c += length;
+            if (reader->variation_depth > 0)
+                continue;
+            if (is_pgn_result(token))
+                end_pgn_game(reader);
+            else if (!read_pgn_move(arr, reader, token))
+                return false;
+        }
+    }
+    return true;
+}
+
+
+static bool has_extension(const char* path, const char* extension)
+{
+    size_t path_length = strlen(path);
+    size_t extension_length = strlen(extension);
+    return path_length >= extension_length && strcmp(path + path_length - extension_length, extension) == 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    size_t max_plies = DEFAULT_BOOK_PLIES;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "--plies") == 0) {
+        max_plies = strtoull(argv[2], NULL, 10);
+        first = 3;
+    }
+    if (argc - first < 2) {
+        fprintf(stderr, "Usage: %s [--plies N] <output.bin> <input.epd|input.pgn>...\n", argv[0]);
+        return 1;
+    }
+
+    BookEntryArray arr;
+    arr.entries = (BookEntry*) malloc(sizeof(BookEntry) * INITIAL_ENTRIES_CAPACITY);
+    if (arr.entries == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        return 1;
+    }
+    arr.capacity = INITIAL_ENTRIES_CAPACITY;
+    arr.count = 0;
+
+    char line[MAX_EPD_LINE];
+    for (int i = first + 1; i < argc; ++i) {
+        FILE* file = fopen(argv[i], "r");
+        if (file == NULL) {
+            fprintf(stderr, "Error: Could not open %s\n", argv[i]);
+            free(arr.entries);
+            return 1;
+        }
+        bool is_pgn = has_extension(argv[i], ".pgn");
+        PgnReader reader = { 0 };
+        reader.max_plies = max_plies;
+        bool ok = true;
+        while (ok && fgets(line, sizeof(line), file) != NULL) {
+            ok = is_pgn ? read_pgn_line(&arr, &reader, line) : read_epd_line(&arr, line);
+        }
+        end_pgn_game(&reader);
+        fclose(file);
+        if (!ok) {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            free(arr.entries);
+            return 1;
+        }
+    }
+
+    size_t moves_read = arr.count;
+    sort_book_entries(arr.entries, &arr.count);
+    bool written = write_book(argv[first], arr.entries, arr.count);
+    if (written)
+        printf("%zu moves read, %zu entries written to %s\n", moves_read, arr.count, argv[first]);
+
+    free(arr.entries);
+    return written ? 0 : 1;
+}
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "chess.h"
 
@@ -30,9 +31,11 @@
 Board* create_default_board(void)
 {
     uint64_t* pieces = malloc(sizeof(uint64_t) * N_PIECES);
-    if (pieces == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed\n");
-        exit(1);
+    Board* result = (Board*) malloc(sizeof(Board));
+    if (pieces == NULL || result == NULL) {
+        free(pieces);
+        free(result);
+        return NULL;
     }
 
     pieces[W_PAWN_I]   = W_PAWNS_S;
@@ -49,14 +52,136 @@ Board* create_default_board(void)
     pieces[B_QUEEN_I]  = B_QUEEN_S;
     pieces[B_KING_I]   = B_KING_S;
 
-    Board* result = (Board*) malloc(sizeof(Board));
     result->pieces = pieces;
     result->turn = WHITE_TURN;
+    result->en_passant = false;
+    result->en_passant_square = 0ULL;
     result->castling_rights = 0x0F;
     return result;
 }
 
 
+// Only the first four fields are read, so EPD lines work too.
+// Also returns NULL if the string is not a valid position.
+Board* create_board_from_fen(const char* fen)
+{
+    uint64_t* pieces = calloc(N_PIECES, sizeof(uint64_t));
+    if (pieces == NULL)
+        return NULL;
+
+    // Piece placement, from row 8 to row 1 and from column 1 to column 8
+    size_t row = ROW_SQUARES;
+    size_t col = 1;
+    for (; *fen != ' '; ++fen) {
+        char c = *fen;
+        const char* piece_char = c != '\0' ? strchr(PIECE_CHARS, c) : NULL;
+        if (c == '/') {
+            if (col != COL_SQUARES + 1 || row == 1)
+                goto invalid;
+            row -= 1;
+            col = 1;
+        } else if (c >= '1' && c <= '8') {
+            col += (size_t) (c - '0');
+            if (col > COL_SQUARES + 1)
+                goto invalid;
+        } else if (piece_char != NULL) {
+            if (col > COL_SQUARES)
+                goto invalid;
+            pieces[piece_char - PIECE_CHARS] |= get_square_position(row, col);
+            col += 1;
+        } else {
+            goto invalid;
+        }
+    }
+    if (row != 1 || col != COL_SQUARES + 1)
+        goto invalid;
+
+    // Turn
+    fen += 1;
+    bool turn;
+    if (*fen == 'w')
+        turn = WHITE_TURN;
+    else if (*fen == 'b')
+        turn = BLACK_TURN;
+    else
+        goto invalid;
+    fen += 1;
+    if (*fen++ != ' ')
+        goto invalid;
+
+    // Castling rights
+    uint8_t castling_rights = 0;
+    if (*fen == '-') {
+        fen += 1;
+    } else {
+        for (; *fen != ' ' && *fen != '\0'; ++fen) {
+            if (*fen == 'K')
+                castling_rights |= W_KINGSIDE_CASTLE;
+            else if (*fen == 'Q')
+                castling_rights |= W_QUEENSIDE_CASTLE;
+            else if (*fen == 'k')
+                castling_rights |= B_KINGSIDE_CASTLE;
+            else if (*fen == 'q')
+                castling_rights |= B_QUEENSIDE_CASTLE;
+            else
+                goto invalid;
+        }
+    }
+    if (*fen++ != ' ')
+        goto invalid;
+
+    // En passant square
+    bool en_passant = false;
+    uint64_t en_passant_square = 0ULL;
+    if (*fen != '-') {
+        if (fen[0] < 'a' || fen[0] > 'h' || (fen[1] != '3' && fen[1] != '6'))
+            goto invalid;
+        en_passant = true;
+        en_passant_square = get_square_position((size_t) (fen[1] - '0'), (size_t) (fen[0] - 'a' + 1));
+    }
+
+    Board* result = (Board*) malloc(sizeof(Board));
+    if (result == NULL)
+        goto invalid;
+    result->pieces = pieces;
+    result->turn = turn;
+    result->en_passant = en_passant;
+    result->en_passant_square = en_passant_square;
+    result->castling_rights = castling_rights;
+    return result;
+
+invalid:
+    free(pieces);
+    return NULL;
+}
+
+
+Board* copy_board(Board* board)
+{
+    uint64_t* pieces = malloc(sizeof(uint64_t) * N_PIECES);
+    Board* result = (Board*) malloc(sizeof(Board));
+    if (pieces == NULL || result == NULL) {
+        free(pieces);
+        free(result);
+        return NULL;
+    }
+    *result = *board;
+    result->pieces = pieces;
+    memcpy(pieces, board->pieces, sizeof(uint64_t) * N_PIECES);
+    return result;
+}
+
+
+// Both boards keep their own pieces arrays
+void copy_board_into(Board* destination, Board* source)
+{
+    uint64_t* pieces = destination->pieces;
+    *destination = *source;
+    destination->pieces = pieces;
+    memcpy(pieces, source->pieces, sizeof(uint64_t) * N_PIECES);
+}
+
+
 void destroy_board(Board* board)
 {
     free(board->pieces);
@@ -130,9 +255,11 @@ PositionArray* get_pieces_positions(uint64_t pieces)
 {
     size_t piece_count = count_bits(pieces);
     uint64_t* pieces_positions = malloc(sizeof(uint64_t) * piece_count);
-    if (pieces_positions == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed\n");
-        exit(1);
+    PositionArray* result = malloc(sizeof(PositionArray));
+    if ((pieces_positions == NULL && piece_count > 0) || result == NULL) {
+        free(pieces_positions);
+        free(result);
+        return NULL;
     }
 
     size_t index = 0;
@@ -144,7 +271,6 @@ PositionArray* get_pieces_positions(uint64_t pieces)
         position = position << 1;
     }
 
-    PositionArray* result = malloc(sizeof(PositionArray));
     result->count = piece_count;
     result->positions = pieces_positions;
     return result;
@@ -202,25 +328,178 @@ size_t get_piece_column(uint64_t piece_position)
 }
 
 
+// Same row and column numbering as get_piece_row and get_piece_column
+uint64_t get_square_position(size_t row, size_t col)
+{
+    return 1ULL << ((row - 1) * ROW_SQUARES + (COL_SQUARES - col));
+}
+
+
+bool get_piece_type_at(Board* board, uint64_t position, PIECE_INDEX* piece_type)
+{
+    for (size_t i = 0; i < N_PIECES; ++i) {
+        if ((board->pieces[i] & position) != 0ULL) {
+            *piece_type = (PIECE_INDEX) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Coordinate notation, "e2e4". The piece is taken from the board.
+bool parse_move(Board* board, const char* str, Move* move)
+{
+    for (size_t i = 0; i < 4; i += 2) {
+        if (str[i] < 'a' || str[i] > 'h' || str[i + 1] < '1' || str[i + 1] > '8')
+            return false;
+    }
+    move->previous_position = get_square_position((size_t) (str[1] - '0'), (size_t) (str[0] - 'a' + 1));
+    move->next_position = get_square_position((size_t) (str[3] - '0'), (size_t) (str[2] - 'a' + 1));
+    return get_piece_type_at(board, move->previous_position, &move->piece_type);
+}
+
+
+static void write_square(char* out, uint64_t position)
+{
+    out[0] = (char) ('a' + get_piece_column(position) - 1);
+    out[1] = (char) ('0' + get_piece_row(position));
+}
+
+
+// move_array holds the board's pseudomoves, to disambiguate. Checks
+// aren't marked and promotions are always to a queen.
+void get_move_san(Board* board, Move* move, MoveArray* move_array, char* san)
+{
+    size_t from_col = get_piece_column(move->previous_position);
+    size_t from_row = get_piece_row(move->previous_position);
+    size_t to_col = get_piece_column(move->next_position);
+    bool is_pawn = move->piece_type == W_PAWN_I || move->piece_type == B_PAWN_I;
+    bool is_king = move->piece_type == W_KING_I || move->piece_type == B_KING_I;
+
+    if (is_king && (from_col == to_col + 2 || to_col == from_col + 2)) {
+        strcpy(san, to_col > from_col ? "O-O" : "O-O-O");
+        return;
+    }
+
+    uint64_t opposite_color_occupied_squares = board->turn == WHITE_TURN
+        ? get_black_occupied_squares(board)
+        : get_white_occupied_squares(board);
+    bool capture = (move->next_position & opposite_color_occupied_squares) != 0ULL
+        || (is_pawn && board->en_passant && move->next_position == board->en_passant_square);
+
+    size_t length = 0;
+    if (is_pawn) {
+        if (capture)
+            san[length++] = (char) ('a' + from_col - 1);
+    } else {
+        san[length++] = PIECE_CHARS[move->piece_type % (N_PIECES / 2)];
+        bool ambiguous = false;
+        bool same_col = false;
+        bool same_row = false;
+        for (size_t i = 0; i < move_array->count; ++i) {
+            Move* other = move_array->moves[i];
+            if (other->piece_type != move->piece_type || other->next_position != move->next_position || other->previous_position == move->previous_position)
+                continue;
+            ambiguous = true;
+            same_col |= get_piece_column(other->previous_position) == from_col;
+            same_row |= get_piece_row(other->previous_position) == from_row;
+        }
+        if (ambiguous && (!same_col || same_row))
+            san[length++] = (char) ('a' + from_col - 1);
+        if (ambiguous && same_col)
+            san[length++] = (char) ('0' + from_row);
+    }
+    if (capture)
+        san[length++] = 'x';
+    write_square(san + length, move->next_position);
+    length += 2;
+    if (is_pawn && (is_piece_in_row(move->next_position, 1) || is_piece_in_row(move->next_position, 8))) {
+        san[length++] = '=';
+        san[length++] = 'Q';
+    }
+    san[length] = '\0';
+}
+
+
+// Finds the move written as san, check marks and annotations are ignored
+bool parse_san_move(Board* board, const char* san, MoveArray* move_array, Move* move)
+{
+    char text[MAX_SAN_LENGTH];
+    size_t length = strcspn(san, "+#!?");
+    if (length == 0 || length >= MAX_SAN_LENGTH)
+        return false;
+    memcpy(text, san, length);
+    text[length] = '\0';
+    for (size_t i = 0; i < length; ++i) {
+        if (text[i] == '0')
+            text[i] = 'O';
+    }
+
+    // Castling isn't generated, the rights are enough
+    bool kingside = strcmp(text, "O-O") == 0;
+    if (kingside || strcmp(text, "O-O-O") == 0) {
+        bool white = board->turn == WHITE_TURN;
+        uint8_t right = white
+            ? (kingside ? W_KINGSIDE_CASTLE : W_QUEENSIDE_CASTLE)
+            : (kingside ? B_KINGSIDE_CASTLE : B_QUEENSIDE_CASTLE);
+        size_t row = white ? 1 : 8;
+        move->piece_type = white ? W_KING_I : B_KING_I;
+        move->previous_position = get_square_position(row, 5);
+        move->next_position = get_square_position(row, kingside ? 7 : 3);
+        return (board->castling_rights & right) && (board->pieces[move->piece_type] & move->previous_position);
+    }
+
+    char candidate[MAX_SAN_LENGTH];
+    for (size_t i = 0; i < move_array->count; ++i) {
+        get_move_san(board, move_array->moves[i], move_array, candidate);
+        if (strcmp(candidate, text) == 0) {
+            *move = *move_array->moves[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+
 MoveArray* create_move_array(void)
 {
     MoveArray* result = (MoveArray*) malloc(sizeof(MoveArray));
-    if (result == NULL) {
-        fprintf(stderr,"Error: Memory allocation failed\n");
-        exit(1);
-    }
+    if (result == NULL)
+        return NULL;
     result->moves = (Move**) malloc(sizeof(Move*) * INITIAL_MOVE_ARRAY_CAPACITY);
     if (result->moves == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed\n");
-        exit(1);
+        free(result);
+        return NULL;
     }
     result->count = 0;
     result->capacity = INITIAL_MOVE_ARRAY_CAPACITY;
+    result->arena = NULL;
+    return result;
+}
+
+
+// The array and its moves go away when the arena is reset
+MoveArray* create_move_array_in(Arena* arena)
+{
+    MoveArray* result = (MoveArray*) arena_alloc(arena, sizeof(MoveArray));
+    if (result == NULL)
+        return NULL;
+    result->moves = (Move**) arena_alloc(arena, sizeof(Move*) * MAX_MOVES);
+    if (result->moves == NULL)
+        return NULL;
+    result->count = 0;
+    result->capacity = MAX_MOVES;
+    result->arena = arena;
     return result;
 }
 
+
+// Does nothing for arena move arrays
 void destroy_move_array(MoveArray* move_array)
 {
+    if (move_array->arena != NULL)
+        return;
     for (size_t i = 0; i < move_array->count; ++i) {
         free(move_array->moves[i]);
     }
@@ -229,38 +508,47 @@ void destroy_move_array(MoveArray* move_array)
 }
 
 
-void insert_move_into_array(MoveArray* arr, Move* move)
+bool insert_move_into_array(MoveArray* arr, Move* move)
 {
     if (arr->count == arr->capacity) {
-        // I'm ending the program if realloc failes so
-        // I think could have done it without a temporal variable
-        Move** temp = (Move**) realloc(arr->moves, sizeof(Move*) * arr->capacity * 2);
-        if (temp == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed\n");
-            exit(1);
+        Move** temp;
+        if (arr->arena != NULL) {
+            // Arena blocks can't grow, the old one stays until the arena is reset
+            temp = (Move**) arena_alloc(arr->arena, sizeof(Move*) * arr->capacity * 2);
+            if (temp != NULL)
+                memcpy(temp, arr->moves, sizeof(Move*) * arr->count);
+        } else {
+            temp = (Move**) realloc(arr->moves, sizeof(Move*) * arr->capacity * 2);
         }
+        if (temp == NULL)
+            return false;
         arr->moves = temp;
         arr->capacity *= 2;
     }
     arr->moves[arr->count++] = move;
+    return true;
 }
 
 
-void insert_moves_into_array(MoveArray* arr, PIECE_INDEX piece_type, uint64_t previous_position, uint64_t next_positions)
+bool insert_moves_into_array(MoveArray* arr, PIECE_INDEX piece_type, uint64_t previous_position, uint64_t next_positions)
 {
-    PositionArray* new_positions = get_pieces_positions(next_positions);
-    for (size_t i = 0; i < new_positions->count; ++i) {
-        Move* move = (Move*) malloc(sizeof(Move));
-        if (move == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed\n");
-            exit(1);
-        }
+    while (next_positions) {
+        Move* move = arr->arena != NULL
+            ? (Move*) arena_alloc(arr->arena, sizeof(Move))
+            : (Move*) malloc(sizeof(Move));
+        if (move == NULL)
+            return false;
         move->piece_type = piece_type;
         move->previous_position = previous_position;
-        move->next_position = new_positions->positions[i];
-        insert_move_into_array(arr, move);
+        move->next_position = next_positions & -next_positions;
+        if (!insert_move_into_array(arr, move)) {
+            if (arr->arena == NULL)
+                free(move);
+            return false;
+        }
+        next_positions &= next_positions - 1;
     }
-    destroy_position_array(new_positions);
+    return true;
 }
 
 
@@ -268,11 +556,11 @@ uint64_t get_pseudomoves_from_white_pawn(Board* board, uint64_t piece_position,
 {
     uint64_t found_positions = 0ULL;
     uint64_t potential_new_position;
-    uint64_t occupied_squares = same_color_occupied_squares & opposite_color_occupied_squares;
-    // Double step
+    uint64_t occupied_squares = same_color_occupied_squares | opposite_color_occupied_squares;
+    // Double step, the square in between has to be empty too
     if (is_piece_in_row(piece_position, 2)) {
         potential_new_position = piece_position << 16;
-        if ((potential_new_position & occupied_squares) == 0ULL) {
+        if (((potential_new_position | (piece_position << 8)) & occupied_squares) == 0ULL) {
             found_positions |= potential_new_position;
         }
     }
@@ -303,11 +591,11 @@ uint64_t get_pseudomoves_from_black_pawn(Board* board, uint64_t piece_position,
 {
     uint64_t found_positions = 0ULL;
     uint64_t potential_new_position;
-    uint64_t occupied_squares = same_color_occupied_squares & opposite_color_occupied_squares;
-    // Double step
-    if (is_piece_in_row(piece_position, 6)) {
+    uint64_t occupied_squares = same_color_occupied_squares | opposite_color_occupied_squares;
+    // Double step, the square in between has to be empty too
+    if (is_piece_in_row(piece_position, 7)) {
         potential_new_position = piece_position >> 16;
-        if ((potential_new_position & occupied_squares) == 0ULL) {
+        if (((potential_new_position | (piece_position >> 8)) & occupied_squares) == 0ULL) {
             found_positions |= potential_new_position;
         }
     }
@@ -325,7 +613,7 @@ uint64_t get_pseudomoves_from_black_pawn(Board* board, uint64_t piece_position,
     }
     // Eat to the right
     if (!is_piece_in_column(piece_position, 8)) {
-        potential_new_position = piece_position >> 8;
+        potential_new_position = piece_position >> 9;
         if ((potential_new_position & opposite_color_occupied_squares) != 0ULL || (board->en_passant && board->en_passant_square == potential_new_position)) {
             found_positions |= potential_new_position;
         }
@@ -375,7 +663,10 @@ uint64_t get_pseudomoves_from_knight(uint64_t piece_position, uint64_t same_colo
     int piece_row = (int) get_piece_row(piece_position);
     int knight_offsets[8] = { -17, -15, -10, -6, 6, 10, 15, 17 };
     for (size_t i = 0; i < 8; ++i) {
-        uint64_t potential_new_position = piece_position << knight_offsets[i];
+        // Shifting by a negative amount is undefined
+        uint64_t potential_new_position = knight_offsets[i] > 0
+            ? piece_position << knight_offsets[i]
+            : piece_position >> -knight_offsets[i];
         if (potential_new_position > 0 && (potential_new_position & same_color_occupied_squares) == 0) {
             int col_difference = piece_col - (int) get_piece_column(potential_new_position);
             int row_difference = piece_row - (int) get_piece_row(potential_new_position);
@@ -426,7 +717,7 @@ uint64_t get_pseudomoves_from_queen(uint64_t piece_position, uint64_t same_color
 {
     uint64_t pseudomoves_as_bishop = get_pseudomoves_from_bishop(piece_position, same_color_occupied_squares, opposite_color_occupied_squares);
     uint64_t pseudomoves_as_rook = get_pseudomoves_from_rook(piece_position, same_color_occupied_squares, opposite_color_occupied_squares);
-    return pseudomoves_as_bishop & pseudomoves_as_rook;
+    return pseudomoves_as_bishop | pseudomoves_as_rook;
 }
 
 
@@ -488,7 +779,7 @@ uint64_t get_pseudomoves_from_king(uint64_t piece_position, uint64_t same_color_
 }
 
 
-void insert_pseudomoves_from_piece(Board* board, MoveArray* move_array, PIECE_INDEX piece_type, uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares)
+bool insert_pseudomoves_from_piece(Board* board, MoveArray* move_array, PIECE_INDEX piece_type, uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares)
 {
     uint64_t next_positions;
     switch (piece_type) {
@@ -522,13 +813,12 @@ void insert_pseudomoves_from_piece(Board* board, MoveArray* move_array, PIECE_IN
         fprintf(stderr, "Unreachable code reached at insert_pseudomoves_from_piece");
         exit(1);
     }
-    insert_moves_into_array(move_array, piece_type, piece_position, next_positions);
+    return insert_moves_into_array(move_array, piece_type, piece_position, next_positions);
 }
 
 
-MoveArray* get_pseudomoves_from_board(Board* board)
+static bool insert_pseudomoves_from_board(Board* board, MoveArray* move_array)
 {
-    MoveArray* move_array = create_move_array();
     size_t starting_index = board->turn == WHITE_TURN ? 0 : (N_PIECES / 2);
     size_t ending_index = starting_index + N_PIECES / 2;
     uint64_t same_color_occupied_squares = get_white_occupied_squares(board);
@@ -539,11 +829,100 @@ MoveArray* get_pseudomoves_from_board(Board* board)
         opposite_color_occupied_squares = temp;
     }
     for (size_t i = starting_index; i < ending_index; ++i) {
-        PositionArray* pieces_positions = get_pieces_positions(board->pieces[i]);
-        for (size_t j = 0; j < pieces_positions->count; ++j) {
-            insert_pseudomoves_from_piece(board, move_array, i, pieces_positions->positions[j], same_color_occupied_squares, opposite_color_occupied_squares);
+        uint64_t pieces = board->pieces[i];
+        while (pieces) {
+            if (!insert_pseudomoves_from_piece(board, move_array, i, pieces & -pieces, same_color_occupied_squares, opposite_color_occupied_squares))
+                return false;
+            pieces &= pieces - 1;
         }
-        destroy_position_array(pieces_positions);
+    }
+    return true;
+}
+
+
+MoveArray* get_pseudomoves_from_board(Board* board)
+{
+    MoveArray* move_array = create_move_array();
+    if (move_array == NULL)
+        return NULL;
+    if (!insert_pseudomoves_from_board(board, move_array)) {
+        destroy_move_array(move_array);
+        return NULL;
     }
     return move_array;
 }
+
+
+// Never calls malloc, which makes it the one to use while searching
+MoveArray* get_pseudomoves_from_board_in(Arena* arena, Board* board)
+{
+    MoveArray* move_array = create_move_array_in(arena);
+    if (move_array == NULL || !insert_pseudomoves_from_board(board, move_array))
+        return NULL;
+    return move_array;
+}
+
+
+// Applies a pseudomove, legality is not checked
+void make_move(Board* board, Move* move)
+{
+    size_t starting_index = board->turn == WHITE_TURN ? 0 : (N_PIECES / 2);
+    size_t opposite_index = board->turn == WHITE_TURN ? (N_PIECES / 2) : 0;
+    uint64_t from = move->previous_position;
+    uint64_t to = move->next_position;
+
+    // Captures
+    for (size_t i = opposite_index; i < opposite_index + N_PIECES / 2; ++i) {
+        board->pieces[i] &= ~to;
+    }
+    if (board->en_passant && to == board->en_passant_square) {
+        if (move->piece_type == W_PAWN_I)
+            board->pieces[B_PAWN_I] &= ~(to >> 8);
+        else if (move->piece_type == B_PAWN_I)
+            board->pieces[W_PAWN_I] &= ~(to << 8);
+    }
+
+    board->pieces[move->piece_type] = (board->pieces[move->piece_type] & ~from) | to;
+
+    // Move has no promotion piece, pawns always become queens
+    if (move->piece_type == W_PAWN_I && is_piece_in_row(to, 8)) {
+        board->pieces[W_PAWN_I] &= ~to;
+        board->pieces[W_QUEEN_I] |= to;
+    } else if (move->piece_type == B_PAWN_I && is_piece_in_row(to, 1)) {
+        board->pieces[B_PAWN_I] &= ~to;
+        board->pieces[B_QUEEN_I] |= to;
+    }
+
+    // Castling moves the rook too
+    if (move->piece_type == W_KING_I || move->piece_type == B_KING_I) {
+        PIECE_INDEX rook_index = starting_index == 0 ? W_ROOK_I : B_ROOK_I;
+        if (to == from >> 2)
+            board->pieces[rook_index] = (board->pieces[rook_index] & ~(from >> 3)) | (from >> 1);
+        else if (to == from << 2)
+            board->pieces[rook_index] = (board->pieces[rook_index] & ~(from << 4)) | (from << 1);
+    }
+
+    // Anything leaving or landing on a king or rook square loses those rights
+    uint64_t touched = from | to;
+    if (touched & (W_KING_S | 0x0000000000000001ULL))
+        board->castling_rights &= (uint8_t) ~W_KINGSIDE_CASTLE;
+    if (touched & (W_KING_S | 0x0000000000000080ULL))
+        board->castling_rights &= (uint8_t) ~W_QUEENSIDE_CASTLE;
+    if (touched & (B_KING_S | 0x0100000000000000ULL))
+        board->castling_rights &= (uint8_t) ~B_KINGSIDE_CASTLE;
+    if (touched & (B_KING_S | 0x8000000000000000ULL))
+        board->castling_rights &= (uint8_t) ~B_QUEENSIDE_CASTLE;
+
+    board->en_passant = false;
+    board->en_passant_square = 0ULL;
+    if (move->piece_type == W_PAWN_I && to == from << 16) {
+        board->en_passant = true;
+        board->en_passant_square = from << 8;
+    } else if (move->piece_type == B_PAWN_I && to == from >> 16) {
+        board->en_passant = true;
+        board->en_passant_square = from >> 8;
+    }
+
+    board->turn = !board->turn;
+}
+
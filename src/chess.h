@@ -27,6 +27,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "arena.h"
+
 
 #define ABS(x) ((x) >= 0 ? (x) : -(x))
 
@@ -39,12 +41,26 @@
 #define BOARD_SQUARES (64)
 #define ROW_SQUARES (8)
 #define COL_SQUARES (8)
+#define MAX_SAN_LENGTH (8)
+
+#define COLUMN_1_SQUARES (0x8080808080808080ULL)
+#define COLUMN_8_SQUARES (0x0101010101010101ULL)
 
 #define INITIAL_MOVE_ARRAY_CAPACITY (16)
+// Arena move arrays start with room for every pseudomove of any position
+#define MAX_MOVES (256)
 
 #define WHITE_TURN (true)
 #define BLACK_TURN (false)
 
+#define W_KINGSIDE_CASTLE  (0x01)
+#define W_QUEENSIDE_CASTLE (0x02)
+#define B_KINGSIDE_CASTLE  (0x04)
+#define B_QUEENSIDE_CASTLE (0x08)
+
+// Same order as PIECE_INDEX
+#define PIECE_CHARS ("PRNBQKprnbqk")
+
 /*
 Sadly, enums should only have values in the range of ints
 
@@ -136,14 +152,21 @@ typedef struct {
     Move** moves;
     size_t capacity;
     size_t count;
+    Arena* arena; // NULL if it lives in the heap
 } MoveArray;
 
 
 /**
  * Functions
+ *
+ * Functions returning pointers return NULL if memory runs out, the ones
+ * returning bool return false.
  */
 
 Board* create_default_board(void);
+Board* create_board_from_fen(const char* fen);
+Board* copy_board(Board* board);
+void copy_board_into(Board* destination, Board* source);
 void destroy_board(Board* board);
 int evaluate_board(Board* board);
 size_t count_bits(uint64_t number);
@@ -156,10 +179,16 @@ bool is_piece_in_row(uint64_t piece_position, size_t row);
 size_t get_piece_row(uint64_t piece_position);
 bool is_piece_in_column(uint64_t piece_position, size_t col);
 size_t get_piece_column(uint64_t piece_position);
+uint64_t get_square_position(size_t row, size_t col);
+bool get_piece_type_at(Board* board, uint64_t position, PIECE_INDEX* piece_type);
+bool parse_move(Board* board, const char* str, Move* move);
+void get_move_san(Board* board, Move* move, MoveArray* move_array, char* san);
+bool parse_san_move(Board* board, const char* san, MoveArray* move_array, Move* move);
 MoveArray* create_move_array(void);
+MoveArray* create_move_array_in(Arena* arena);
 void destroy_move_array(MoveArray* move_array);
-void insert_move_into_array(MoveArray* arr, Move* item);
-void insert_moves_into_array(MoveArray* arr, PIECE_INDEX piece_type, uint64_t previous_position, uint64_t next_positions);
+bool insert_move_into_array(MoveArray* arr, Move* item);
+bool insert_moves_into_array(MoveArray* arr, PIECE_INDEX piece_type, uint64_t previous_position, uint64_t next_positions);
 uint64_t get_pseudomoves_from_white_pawn(Board* board, uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares);
 uint64_t get_pseudomoves_from_black_pawn(Board* board, uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares);
 uint64_t get_pseudomoves_from_rook(uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares);
@@ -167,8 +196,10 @@ uint64_t get_pseudomoves_from_knight(uint64_t piece_position, uint64_t same_colo
 uint64_t get_pseudomoves_from_bishop(uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares);
 uint64_t get_pseudomoves_from_queen(uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares);
 uint64_t get_pseudomoves_from_king(uint64_t piece_position, uint64_t same_color_occupied_squares);
-void insert_pseudomoves_from_piece(Board* board, MoveArray* move_array, PIECE_INDEX piece_type, uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares);
+bool insert_pseudomoves_from_piece(Board* board, MoveArray* move_array, PIECE_INDEX piece_type, uint64_t piece_position, uint64_t same_color_occupied_squares, uint64_t opposite_color_occupied_squares);
 MoveArray* get_pseudomoves_from_board(Board* board);
+MoveArray* get_pseudomoves_from_board_in(Arena* arena, Board* board);
+void make_move(Board* board, Move* move);
 
 
 #endif // CHESS_H
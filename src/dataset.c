@@ -0,0 +1,229 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dataset.h"
+
+
+_Static_assert(sizeof(PackedPosition) == PACKED_POSITION_SIZE, "PackedPosition must be 32 bytes");
+
+
+// False if the board has more than PACKED_MAX_PIECES pieces. The score is
+// clamped to fit in 16 bits.
+bool pack_position(Board* board, int score, int result, PackedPosition* packed)
+{
+    uint64_t occupancy = 0ULL;
+    uint8_t square_pieces[BOARD_SQUARES];
+    for (size_t i = 0; i < N_PIECES; ++i) {
+        uint64_t pieces = board->pieces[i];
+        occupancy |= pieces;
+        while (pieces) {
+            square_pieces[__builtin_ctzll(pieces)] = (uint8_t) i;
+            pieces &= pieces - 1;
+        }
+    }
+
+    memset(packed, 0, sizeof(PackedPosition));
+    for (size_t i = 0; i < 8; ++i) {
+        packed->occupancy[i] = (uint8_t) (occupancy >> (i * 8));
+    }
+
+    for (size_t slot = 0; occupancy; ++slot) {
+        if (slot == PACKED_MAX_PIECES)
+            return false;
+        packed->pieces[slot / 2] |= (uint8_t) (square_pieces[__builtin_ctzll(occupancy)] << (slot % 2 * 4));
+        occupancy &= occupancy - 1;
+    }
+
+    packed->flags = (uint8_t) ((board->turn == WHITE_TURN ? PACKED_TURN : 0) | ((board->castling_rights << 1) & PACKED_CASTLING));
+    if (board->en_passant) {
+        packed->flags |= PACKED_EN_PASSANT;
+        packed->en_passant_column = (uint8_t) get_piece_column(board->en_passant_square);
+    }
+
+    if (score > PACKED_SCORE_MAX)
+        score = PACKED_SCORE_MAX;
+    if (score < -PACKED_SCORE_MAX)
+        score = -PACKED_SCORE_MAX;
+    uint16_t encoded_score = (uint16_t) (int16_t) score;
+    packed->score[0] = (uint8_t) (encoded_score & 0xFF);
+    packed->score[1] = (uint8_t) (encoded_score >> 8);
+    packed->result = (int8_t) result;
+    return true;
+}
+
+
+// board must already have its pieces array. False if the piece codes are
+// invalid, which means the data is corrupt.
+bool unpack_position(const PackedPosition* packed, Board* board, int* score, int* result)
+{
+    uint64_t occupancy = 0ULL;
+    for (size_t i = 0; i < 8; ++i) {
+        occupancy |= (uint64_t) packed->occupancy[i] << (i * 8);
+    }
+    memset(board->pieces, 0, sizeof(uint64_t) * N_PIECES);
+    for (size_t slot = 0; occupancy; ++slot) {
+        if (slot == PACKED_MAX_PIECES)
+            return false;
+        size_t piece_type = (packed->pieces[slot / 2] >> (slot % 2 * 4)) & 0x0F;
+        if (piece_type >= N_PIECES)
+            return false;
+        board->pieces[piece_type] |= occupancy & -occupancy;
+        occupancy &= occupancy - 1;
+    }
+
+    board->turn = (packed->flags & PACKED_TURN) ? WHITE_TURN : BLACK_TURN;
+    board->castling_rights = (uint8_t) ((packed->flags & PACKED_CASTLING) >> 1);
+    board->en_passant = (packed->flags & PACKED_EN_PASSANT) != 0;
+    board->en_passant_square = 0ULL;
+    if (board->en_passant) {
+        if (packed->en_passant_column < 1 || packed->en_passant_column > COL_SQUARES)
+            return false;
+        board->en_passant_square = get_square_position(board->turn == WHITE_TURN ? 6 : 3, packed->en_passant_column);
+    }
+
+    *score = (int16_t) (uint16_t) (packed->score[0] | (packed->score[1] << 8));
+    *result = packed->result;
+    return true;
+}
+
+
+// capacity is in positions, 0 for DEFAULT_WRITER_CAPACITY
+PositionWriter* create_position_writer(const char* path, size_t capacity)
+{
+    if (capacity == 0)
+        capacity = DEFAULT_WRITER_CAPACITY;
+    PositionWriter* result = (PositionWriter*) malloc(sizeof(PositionWriter));
+    if (result == NULL)
+        return NULL;
+    result->buffer = (PackedPosition*) malloc(sizeof(PackedPosition) * capacity);
+    if (result->buffer == NULL) {
+        free(result);
+        return NULL;
+    }
+    result->file = fopen(path, "wb");
+    if (result->file == NULL) {
+        fprintf(stderr, "Error: Could not create %s\n", path);
+        free(result->buffer);
+        free(result);
+        return NULL;
+    }
+    // The buffer above already batches the writes
+    setvbuf(result->file, NULL, _IONBF, 0);
+    result->capacity = capacity;
+    result->count = 0;
+    result->written = 0;
+    return result;
+}
+
+
+bool flush_position_writer(PositionWriter* writer)
+{
+    if (writer->count == 0)
+        return true;
+    size_t count = writer->count;
+    size_t written = fwrite(writer->buffer, sizeof(PackedPosition), count, writer->file);
+    writer->written += written;
+    writer->count = 0;
+    return written == count;
+}
+
+
+bool write_packed_position(PositionWriter* writer, PackedPosition* packed)
+{
+    if (writer->count == writer->capacity && !flush_position_writer(writer))
+        return false;
+    writer->buffer[writer->count++] = *packed;
+    return true;
+}
+
+
+// Flushes and frees the writer, false if something couldn't be written
+bool close_position_writer(PositionWriter* writer)
+{
+    bool result = flush_position_writer(writer);
+    result = fclose(writer->file) == 0 && result;
+    free(writer->buffer);
+    free(writer);
+    return result;
+}
+
+
+PositionReader* open_position_reader(const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Could not open %s\n", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size % PACKED_POSITION_SIZE != 0) {
+        fprintf(stderr, "Error: %s is not a packed position file\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    PositionReader* result = (PositionReader*) malloc(sizeof(PositionReader));
+    if (result == NULL) {
+        close(fd);
+        return NULL;
+    }
+    result->size = (size_t) st.st_size;
+    result->count = result->size / PACKED_POSITION_SIZE;
+    result->positions = NULL;
+
+    if (result->size > 0) {
+        void* data = mmap(NULL, result->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            fprintf(stderr, "Error: Could not map %s\n", path);
+            close(fd);
+            free(result);
+            return NULL;
+        }
+        result->positions = data;
+    }
+
+    close(fd);
+    return result;
+}
+
+
+void close_position_reader(PositionReader* reader)
+{
+    if (reader->positions != NULL)
+        munmap((void*) reader->positions, reader->size);
+    free(reader);
+}
+
+
+const PackedPosition* get_packed_position(PositionReader* reader, size_t index)
+{
+    return &reader->positions[index];
+}
@@ -0,0 +1,98 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "chess.h"
+
+
+/**
+ * Constants
+ */
+
+#define PACKED_POSITION_SIZE (32)
+#define PACKED_MAX_PIECES (32)
+#define PACKED_SCORE_MAX (32767)
+
+#define PACKED_TURN       (0x01) // White to move
+#define PACKED_CASTLING   (0x1E) // castling_rights << 1
+#define PACKED_EN_PASSANT (0x20)
+
+#define DEFAULT_WRITER_CAPACITY (1 << 16)
+
+
+/**
+ * Structs
+ */
+
+// Bytes only, so there is no padding and no byte order to care about.
+// Score and result are from the side to move's point of view.
+typedef struct {
+    uint8_t occupancy[8];      // Little endian bitboard
+    uint8_t pieces[16];        // PIECE_INDEX of each occupied square from the lowest bit, low nibble first
+    uint8_t flags;             // PACKED_TURN | PACKED_CASTLING | PACKED_EN_PASSANT
+    uint8_t en_passant_column; // Same numbering as get_piece_column
+    uint8_t score[2];          // Little endian int16
+    int8_t result;             // 1 win, 0 draw, -1 loss
+    uint8_t reserved[3];
+} PackedPosition;
+
+
+// Buffers positions and writes them in big blocks
+typedef struct {
+    FILE* file;
+    PackedPosition* buffer;
+    size_t capacity;
+    size_t count;
+    uint64_t written;
+} PositionWriter;
+
+
+typedef struct {
+    const PackedPosition* positions;
+    size_t count;
+    size_t size;
+} PositionReader;
+
+
+/**
+ * Functions
+ */
+
+bool pack_position(Board* board, int score, int result, PackedPosition* packed);
+bool unpack_position(const PackedPosition* packed, Board* board, int* score, int* result);
+PositionWriter* create_position_writer(const char* path, size_t capacity);
+bool write_packed_position(PositionWriter* writer, PackedPosition* packed);
+bool flush_position_writer(PositionWriter* writer);
+bool close_position_writer(PositionWriter* writer);
+PositionReader* open_position_reader(const char* path);
+void close_position_reader(PositionReader* reader);
+const PackedPosition* get_packed_position(PositionReader* reader, size_t index);
+
+
+#endif // DATASET_H
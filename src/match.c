@@ -0,0 +1,435 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// Self-play match between two search configurations, A and B, played in
+// this process by a pool of threads, one game per thread at a time.
+// Every opening is played twice, once with each engine as white. Both
+// engines share this build's search, only their limits differ.
+//
+// Usage: match [--games N] [--threads N] [--openings <file.epd>] [--pgn <file.pgn>]
+//              [--depth-a N] [--nodes-a N] [--time-a S]
+//              [--depth-b N] [--nodes-b N] [--time-b S]
+//              [--sprt <elo0> <elo1>] [--alpha A] [--beta B] [--dataset <file>]
+//
+// An engine given no limit at all searches DEFAULT_NODES nodes per move.
+// With --sprt the match stops as soon as the test accepts a hypothesis.
+// --dataset writes every position played, with its search score and the
+// game's result, as PackedPosition records.
+
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataset.h"
+#include "memory.h"
+#include "search.h"
+#include "selfplay.h"
+
+
+#define DEFAULT_GAMES (100)
+#define DEFAULT_THREADS (1)
+#define DEFAULT_NODES (10000)
+#define MAX_OPENINGS (100000)
+#define REPORT_EVERY_GAMES (100)
+
+
+typedef struct {
+    char** openings;
+    size_t opening_count;
+    SearchLimits limits_a;
+    SearchLimits limits_b;
+    size_t games;
+    bool sprt;
+    double elo0;
+    double elo1;
+    double lower_bound;
+    double upper_bound;
+    FILE* pgn;
+    PositionWriter* dataset;
+    EngineMemory memory;
+    double start_time;
+
+    // Everything below is only touched with the lock held
+    pthread_mutex_t lock;
+    size_t next_game;
+    size_t finished_games;
+    bool stop;
+    MatchResults results;
+    uint64_t nodes;
+    ENGINE_ERROR error;
+    bool write_failed;
+} Match;
+
+
+typedef struct {
+    Match* match;
+    size_t thread;
+} Worker;
+
+
+static void print_results(Match* match)
+{
+    MatchResults* results = &match->results;
+    double elapsed = get_time() - match->start_time;
+    printf("Games: %zu  W: %llu  D: %llu  L: %llu  Score: %.3f  Elo: %.1f +/- %.1f  %.2f games/s",
+           match->finished_games, (unsigned long long) results->wins, (unsigned long long) results->draws,
+           (unsigned long long) results->losses, get_match_score(results), get_elo(results), get_elo_error(results),
+           elapsed > 0.0 ? (double) match->finished_games / elapsed : 0.0);
+    if (match->sprt)
+        printf("  LLR: %.2f (%.2f, %.2f)", get_sprt_llr(results, match->elo0, match->elo1), match->lower_bound, match->upper_bound);
+    printf("\n");
+    fflush(stdout);
+}
+
+
+// Replays the game to pack the position before every move, positions
+// needs room for MAX_GAME_PLIES
+static ENGINE_ERROR pack_game_positions(Game* game, ThreadMemory* memory, PackedPosition* positions, size_t* count)
+{
+    Board* initial_board = create_board_from_fen(game->fen);
+    Board* board = acquire_board(&memory->boards);
+    ENGINE_ERROR result = initial_board != NULL && board != NULL ? ENGINE_OK : ENGINE_OUT_OF_MEMORY;
+    if (result == ENGINE_OK)
+        copy_board_into(board, initial_board);
+
+    *count = 0;
+    for (size_t i = 0; result == ENGINE_OK && i < game->ply_count; ++i) {
+        int game_result = game->result == GAME_DRAW ? 0 : 1;
+        if ((game->result == GAME_WHITE_WINS) != (board->turn == WHITE_TURN))
+            game_result = -game_result;
+        if (pack_position(board, game->scores[i], game_result, &positions[*count]))
+            *count += 1;
+        make_move(board, &game->moves[i]);
+    }
+
+    if (initial_board != NULL)
+        destroy_board(initial_board);
+    if (board != NULL)
+        release_board(&memory->boards, board);
+    return result;
+}
+
+
+// The game's PGN in a malloc'd buffer, so that only appending it needs the lock
+static ENGINE_ERROR get_game_pgn(Game* game, bool a_is_white, size_t round, ThreadMemory* memory, char** text, size_t* size)
+{
+    *text = NULL;
+    FILE* stream = open_memstream(text, size);
+    if (stream == NULL)
+        return ENGINE_OUT_OF_MEMORY;
+    ENGINE_ERROR result = write_game_pgn(stream, game, a_is_white ? "A" : "B", a_is_white ? "B" : "A", round, memory);
+    if (fclose(stream) != 0)
+        result = ENGINE_OUT_OF_MEMORY;
+    if (result != ENGINE_OK) {
+        free(*text);
+        *text = NULL;
+    }
+    return result;
+}
+
+
+static void* run_worker(void* arg)
+{
+    Worker* worker = arg;
+    Match* match = worker->match;
+    ThreadMemory* memory = get_thread_memory(&match->memory, worker->thread);
+    Game* game = malloc(sizeof(Game));
+    PackedPosition* positions = match->dataset != NULL ? malloc(sizeof(PackedPosition) * MAX_GAME_PLIES) : NULL;
+    if (game == NULL || (match->dataset != NULL && positions == NULL)) {
+        free(game);
+        free(positions);
+        pthread_mutex_lock(&match->lock);
+        match->error = ENGINE_OUT_OF_MEMORY;
+        match->stop = true;
+        pthread_mutex_unlock(&match->lock);
+        return NULL;
+    }
+
+    while (true) {
+        pthread_mutex_lock(&match->lock);
+        bool done = match->stop || match->next_game >= match->games;
+        size_t index = match->next_game++;
+        pthread_mutex_unlock(&match->lock);
+        if (done)
+            break;
+
+        // Game pairs share the opening, A is white in the even ones
+        const char* fen = match->openings[(index / 2) % match->opening_count];
+        bool a_is_white = index % 2 == 0;
+        SearchLimits* white = a_is_white ? &match->limits_a : &match->limits_b;
+        SearchLimits* black = a_is_white ? &match->limits_b : &match->limits_a;
+        ENGINE_ERROR error = play_game(game, fen, white, black, memory);
+
+        // Replaying the game is done before taking the lock, with it held
+        // there's only the appending left
+        char* pgn_text = NULL;
+        size_t pgn_size = 0;
+        if (error == ENGINE_OK && match->pgn != NULL)
+            error = get_game_pgn(game, a_is_white, index + 1, memory, &pgn_text, &pgn_size);
+        size_t position_count = 0;
+        if (error == ENGINE_OK && positions != NULL)
+            error = pack_game_positions(game, memory, positions, &position_count);
+
+        pthread_mutex_lock(&match->lock);
+        if (error != ENGINE_OK) {
+            match->error = error;
+            match->stop = true;
+            pthread_mutex_unlock(&match->lock);
+            free(pgn_text);
+            break;
+        }
+        if (game->result == GAME_DRAW)
+            match->results.draws += 1;
+        else if ((game->result == GAME_WHITE_WINS) == a_is_white)
+            match->results.wins += 1;
+        else
+            match->results.losses += 1;
+        match->nodes += game->nodes;
+        match->finished_games += 1;
+        if (pgn_text != NULL && fwrite(pgn_text, 1, pgn_size, match->pgn) != pgn_size) {
+            fprintf(stderr, "Error: Could not write the PGN\n");
+            match->write_failed = true;
+            match->stop = true;
+        }
+        for (size_t i = 0; i < position_count && !match->write_failed; ++i) {
+            if (!write_packed_position(match->dataset, &positions[i])) {
+                fprintf(stderr, "Error: Could not write positions\n");
+                match->write_failed = true;
+                match->stop = true;
+            }
+        }
+        if (match->sprt) {
+            double llr = get_sprt_llr(&match->results, match->elo0, match->elo1);
+            if (llr <= match->lower_bound || llr >= match->upper_bound)
+                match->stop = true;
+        }
+        if (match->finished_games % REPORT_EVERY_GAMES == 0)
+            print_results(match);
+        pthread_mutex_unlock(&match->lock);
+        free(pgn_text);
+    }
+
+    free(positions);
+    free(game);
+    return NULL;
+}
+
+
+static bool read_openings(Match* match, const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open %s\n", path);
+        return false;
+    }
+    match->openings = malloc(sizeof(char*) * MAX_OPENINGS);
+    if (match->openings == NULL) {
+        fclose(file);
+        return false;
+    }
+    match->opening_count = 0;
+
+    char line[1024];
+    while (match->opening_count < MAX_OPENINGS && fgets(line, sizeof(line), file) != NULL) {
+        Board* board = create_board_from_fen(line);
+        if (board == NULL)
+            continue;
+        destroy_board(board);
+
+        // Keep the four position fields only
+        char* end = line;
+        for (size_t i = 0; i < 4 && end != NULL; ++i) {
+            end = strchr(end + (i > 0), ' ');
+        }
+        if (end != NULL)
+            *end = '\0';
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strlen(line) >= MAX_FEN_LENGTH)
+            continue;
+        match->openings[match->opening_count] = malloc(strlen(line) + 1);
+        if (match->openings[match->opening_count] == NULL)
+            break;
+        strcpy(match->openings[match->opening_count++], line);
+    }
+    fclose(file);
+
+    if (match->opening_count == 0) {
+        fprintf(stderr, "Error: No valid positions in %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--games N] [--threads N] [--openings <file.epd>] [--pgn <file.pgn>]\n", program);
+    fprintf(stderr, "       [--depth-a N] [--nodes-a N] [--time-a S] [--depth-b N] [--nodes-b N] [--time-b S]\n");
+    fprintf(stderr, "       [--sprt <elo0> <elo1>] [--alpha A] [--beta B] [--dataset <file>]\n");
+}
+
+
+int main(int argc, char** argv)
+{
+    static Match match;
+    size_t threads = DEFAULT_THREADS;
+    const char* openings_path = NULL;
+    const char* pgn_path = NULL;
+    const char* dataset_path = NULL;
+    double alpha = 0.05;
+    double beta = 0.05;
+    match.games = DEFAULT_GAMES;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--games") == 0 && has_value) {
+            match.games = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--threads") == 0 && has_value) {
+            threads = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--openings") == 0 && has_value) {
+            openings_path = argv[++i];
+        } else if (strcmp(arg, "--pgn") == 0 && has_value) {
+            pgn_path = argv[++i];
+        } else if (strcmp(arg, "--dataset") == 0 && has_value) {
+            dataset_path = argv[++i];
+        } else if (strcmp(arg, "--depth-a") == 0 && has_value) {
+            match.limits_a.depth = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--nodes-a") == 0 && has_value) {
+            match.limits_a.nodes = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--time-a") == 0 && has_value) {
+            match.limits_a.time = strtod(argv[++i], NULL);
+        } else if (strcmp(arg, "--depth-b") == 0 && has_value) {
+            match.limits_b.depth = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--nodes-b") == 0 && has_value) {
+            match.limits_b.nodes = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--time-b") == 0 && has_value) {
+            match.limits_b.time = strtod(argv[++i], NULL);
+        } else if (strcmp(arg, "--sprt") == 0 && i + 2 < argc) {
+            match.sprt = true;
+            match.elo0 = strtod(argv[++i], NULL);
+            match.elo1 = strtod(argv[++i], NULL);
+        } else if (strcmp(arg, "--alpha") == 0 && has_value) {
+            alpha = strtod(argv[++i], NULL);
+        } else if (strcmp(arg, "--beta") == 0 && has_value) {
+            beta = strtod(argv[++i], NULL);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (threads == 0 || match.games == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    SearchLimits* limits[2] = { &match.limits_a, &match.limits_b };
+    for (size_t i = 0; i < 2; ++i) {
+        if (limits[i]->depth == 0 && limits[i]->nodes == 0 && limits[i]->time <= 0.0)
+            limits[i]->nodes = DEFAULT_NODES;
+    }
+    match.lower_bound = log(beta / (1.0 - alpha));
+    match.upper_bound = log((1.0 - beta) / alpha);
+
+    static char* default_openings[] = { STARTING_FEN };
+    match.openings = default_openings;
+    match.opening_count = 1;
+    if (openings_path != NULL && !read_openings(&match, openings_path))
+        return 1;
+
+    if (pgn_path != NULL) {
+        match.pgn = fopen(pgn_path, "w");
+        if (match.pgn == NULL) {
+            fprintf(stderr, "Error: Could not create %s\n", pgn_path);
+            return 1;
+        }
+    }
+
+    if (dataset_path != NULL) {
+        match.dataset = create_position_writer(dataset_path, DEFAULT_WRITER_CAPACITY);
+        if (match.dataset == NULL)
+            return 1;
+    }
+
+    MemoryConfig config = get_memory_config(threads, SELFPLAY_MAX_DEPTH);
+    if (create_engine_memory(&match.memory, &config) != ENGINE_OK) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        return 1;
+    }
+
+    pthread_t* thread_ids = malloc(sizeof(pthread_t) * threads);
+    Worker* workers = malloc(sizeof(Worker) * threads);
+    if (thread_ids == NULL || workers == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        return 1;
+    }
+    pthread_mutex_init(&match.lock, NULL);
+    match.start_time = get_time();
+    size_t started = 0;
+    for (; started < threads; ++started) {
+        workers[started].match = &match;
+        workers[started].thread = started;
+        if (pthread_create(&thread_ids[started], NULL, run_worker, &workers[started]) != 0) {
+            fprintf(stderr, "Error: Could not start thread %zu\n", started);
+            break;
+        }
+    }
+    for (size_t i = 0; i < started; ++i) {
+        pthread_join(thread_ids[i], NULL);
+    }
+    pthread_mutex_destroy(&match.lock);
+
+    double elapsed = get_time() - match.start_time;
+    print_results(&match);
+    printf("Nodes: %llu  %.0f nodes/s\n", (unsigned long long) match.nodes, elapsed > 0.0 ? (double) match.nodes / elapsed : 0.0);
+    if (match.sprt) {
+        double llr = get_sprt_llr(&match.results, match.elo0, match.elo1);
+        const char* verdict = llr >= match.upper_bound ? "H1 accepted" : llr <= match.lower_bound ? "H0 accepted" : "Inconclusive";
+        printf("SPRT [%.1f, %.1f]: %s\n", match.elo0, match.elo1, verdict);
+    }
+    if (match.error != ENGINE_OK)
+        fprintf(stderr, "Error: A game ran out of memory\n");
+
+    if (match.pgn != NULL && fclose(match.pgn) != 0) {
+        fprintf(stderr, "Error: Could not write the PGN\n");
+        match.write_failed = true;
+    }
+    if (match.dataset != NULL) {
+        printf("Positions: %llu\n", (unsigned long long) (match.dataset->written + match.dataset->count));
+        if (!close_position_writer(match.dataset)) {
+            fprintf(stderr, "Error: Could not write positions\n");
+            match.write_failed = true;
+        }
+    }
+    if (openings_path != NULL) {
+        for (size_t i = 0; i < match.opening_count; ++i) {
+            free(match.openings[i]);
+        }
+        free(match.openings);
+    }
+    free(thread_ids);
+    free(workers);
+    destroy_engine_memory(&match.memory);
+    return match.error == ENGINE_OK && !match.write_failed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "memory.h"
+
+
+#define ROUND_UP(x, n) (((x) + (n) - 1) / (n) * (n))
+
+
+void init_board_pool(BoardPool* pool, BoardSlot* slots, size_t capacity)
+{
+    pool->slots = slots;
+    pool->capacity = capacity;
+    pool->free_slots = NULL;
+    for (size_t i = capacity; i > 0; --i) {
+        slots[i - 1].board.pieces = slots[i - 1].pieces;
+        slots[i - 1].next_free = pool->free_slots;
+        pool->free_slots = &slots[i - 1];
+    }
+}
+
+
+// The board's contents are whatever its last user left
+Board* acquire_board(BoardPool* pool)
+{
+    BoardSlot* slot = pool->free_slots;
+    if (slot == NULL)
+        return NULL;
+    pool->free_slots = slot->next_free;
+    return &slot->board;
+}
+
+
+void release_board(BoardPool* pool, Board* board)
+{
+    // board is the first member, so this is the slot
+    BoardSlot* slot = (BoardSlot*) board;
+    slot->next_free = pool->free_slots;
+    pool->free_slots = slot;
+}
+
+
+// Enough for a search or perft of max_depth: one board and one move array
+// per ply, twice over in case some position has more than MAX_MOVES moves
+MemoryConfig get_memory_config(size_t threads, size_t max_depth)
+{
+    size_t move_array_size = ROUND_UP(sizeof(MoveArray), ARENA_ALIGNMENT)
+        + ROUND_UP(sizeof(Move*) * MAX_MOVES, ARENA_ALIGNMENT)
+        + ROUND_UP(sizeof(Move), ARENA_ALIGNMENT) * MAX_MOVES;
+    MemoryConfig result;
+    result.threads = threads;
+    result.arena_size = 2 * (max_depth + 1) * move_array_size;
+    result.boards = max_depth + 1;
+    return result;
+}
+
+
+// The only allocation, nothing else is allocated while the engine runs
+ENGINE_ERROR create_engine_memory(EngineMemory* memory, MemoryConfig* config)
+{
+    size_t threads_size = ROUND_UP(sizeof(ThreadMemory) * config->threads, THREAD_MEMORY_ALIGNMENT);
+    size_t arena_size = ROUND_UP(config->arena_size, THREAD_MEMORY_ALIGNMENT);
+    size_t boards_size = ROUND_UP(sizeof(BoardSlot) * config->boards, THREAD_MEMORY_ALIGNMENT);
+    size_t size = threads_size + config->threads * (arena_size + boards_size);
+
+    unsigned char* reservation = aligned_alloc(THREAD_MEMORY_ALIGNMENT, size);
+    if (reservation == NULL)
+        return ENGINE_OUT_OF_MEMORY;
+
+    memory->reservation = reservation;
+    memory->size = size;
+    memory->threads = (ThreadMemory*) reservation;
+    memory->thread_count = config->threads;
+
+    unsigned char* next = reservation + threads_size;
+    for (size_t i = 0; i < config->threads; ++i) {
+        init_arena(&memory->threads[i].arena, next, arena_size);
+        next += arena_size;
+        init_board_pool(&memory->threads[i].boards, (BoardSlot*) next, config->boards);
+        next += boards_size;
+    }
+    return ENGINE_OK;
+}
+
+
+void destroy_engine_memory(EngineMemory* memory)
+{
+    free(memory->reservation);
+    memory->reservation = NULL;
+    memory->threads = NULL;
+    memory->thread_count = 0;
+}
+
+
+ThreadMemory* get_thread_memory(EngineMemory* memory, size_t thread)
+{
+    return &memory->threads[thread];
+}
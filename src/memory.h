@@ -0,0 +1,107 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "chess.h"
+
+
+/**
+ * Constants
+ */
+
+// Keeps every thread's memory on its own cache lines
+#define THREAD_MEMORY_ALIGNMENT (64)
+
+
+/**
+ * Enums
+ */
+
+typedef enum {
+    ENGINE_OK            = 0,
+    ENGINE_OUT_OF_MEMORY = 1,
+} ENGINE_ERROR;
+
+
+/**
+ * Structs
+ */
+
+typedef struct BoardSlot {
+    Board board;
+    uint64_t pieces[N_PIECES];
+    struct BoardSlot* next_free;
+} BoardSlot;
+
+
+// Fixed number of boards, acquire_board returns NULL once all are taken
+typedef struct {
+    BoardSlot* slots;
+    BoardSlot* free_slots;
+    size_t capacity;
+} BoardPool;
+
+
+// Everything a single thread needs to search, only that thread touches it.
+// The alignment pads it to whole cache lines inside the threads array.
+typedef struct {
+    _Alignas(THREAD_MEMORY_ALIGNMENT) Arena arena;
+    BoardPool boards;
+} ThreadMemory;
+
+
+typedef struct {
+    size_t threads;
+    size_t arena_size; // Per thread
+    size_t boards;     // Per thread
+} MemoryConfig;
+
+
+// One reservation split between the threads
+typedef struct {
+    void* reservation;
+    size_t size;
+    ThreadMemory* threads;
+    size_t thread_count;
+} EngineMemory;
+
+
+/**
+ * Functions
+ */
+
+void init_board_pool(BoardPool* pool, BoardSlot* slots, size_t capacity);
+Board* acquire_board(BoardPool* pool);
+void release_board(BoardPool* pool, Board* board);
+MemoryConfig get_memory_config(size_t threads, size_t max_depth);
+ENGINE_ERROR create_engine_memory(EngineMemory* memory, MemoryConfig* config);
+void destroy_engine_memory(EngineMemory* memory);
+ThreadMemory* get_thread_memory(EngineMemory* memory, size_t thread);
+
+
+#endif // MEMORY_H
@@ -0,0 +1,266 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "attacks.h"
+#include "search.h"
+
+
+// Monotonic, in seconds
+double get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+
+static bool should_stop(Search* search)
+{
+    if (search->max_nodes != 0 && search->nodes >= search->max_nodes)
+        return true;
+    return search->deadline != 0.0 && search->nodes % TIME_CHECK_NODES == 0 && get_time() >= search->deadline;
+}
+
+
+// evaluate_board is from white's point of view, negamax wants the side to move's
+int evaluate_board_for_turn(Board* board)
+{
+    int evaluation = evaluate_board(board);
+    return board->turn == WHITE_TURN ? evaluation : -evaluation;
+}
+
+
+// Fail-hard alpha-beta over pseudomoves. ply counts the moves from the
+// root so that nearer mates score higher.
+int negamax(Board* board, size_t depth, size_t ply, int alpha, int beta, Search* search)
+{
+    if (search->stopped || should_stop(search)) {
+        search->stopped = true;
+        return 0;
+    }
+    search->nodes += 1;
+    SEARCH_TRACE_EVENT(search, TRACE_ENTER, depth, alpha, beta, 0);
+
+    PIECE_INDEX king_index = board->turn == WHITE_TURN ? W_KING_I : B_KING_I;
+    if (board->pieces[king_index] == 0ULL) {
+        int score = -KING_LOST_SCORE + (int) ply;
+        SEARCH_STATS_ADD(search, king_captures, 1);
+        SEARCH_TRACE_EVENT(search, TRACE_LEAF, depth, alpha, beta, score);
+        return score;
+    }
+    // The last move left its own king hanging
+    if (is_square_attacked(board, board->pieces[king_index == W_KING_I ? B_KING_I : W_KING_I], board->turn)) {
+        search->illegal_move = true;
+        SEARCH_STATS_ADD(search, king_captures, 1);
+        SEARCH_TRACE_EVENT(search, TRACE_LEAF, depth, alpha, beta, KING_LOST_SCORE);
+        return KING_LOST_SCORE;
+    }
+    if (depth == 0) {
+        int evaluation = evaluate_board_for_turn(board);
+        SEARCH_STATS_ADD(search, leaf_nodes, 1);
+        SEARCH_TRACE_EVENT(search, TRACE_LEAF, depth, alpha, beta, evaluation);
+        return evaluation;
+    }
+
+    Arena* arena = &search->memory->arena;
+    size_t mark = get_arena_mark(arena);
+    MoveArray* move_array = get_pseudomoves_from_board_in(arena, board);
+    if (move_array == NULL) {
+        search->error = ENGINE_OUT_OF_MEMORY;
+        reset_arena(arena, mark);
+        return 0;
+    }
+    SEARCH_STATS_ADD(search, generation_calls, 1);
+    SEARCH_STATS_ADD(search, moves_generated, move_array->count);
+
+    Board* child = acquire_board(&search->memory->boards);
+    if (child == NULL) {
+        search->error = ENGINE_OUT_OF_MEMORY;
+        reset_arena(arena, mark);
+        return 0;
+    }
+
+    size_t legal_moves = 0;
+    for (size_t i = 0; i < move_array->count; ++i) {
+        copy_board_into(child, board);
+        make_move(child, move_array->moves[i]);
+        int score = -negamax(child, depth - 1, ply + 1, -beta, -alpha, search);
+        if (search->error != ENGINE_OK || search->stopped)
+            break;
+        if (search->illegal_move) {
+            search->illegal_move = false;
+            continue;
+        }
+        legal_moves += 1;
+        if (score >= beta) {
+            SEARCH_STATS_ADD(search, beta_cutoffs, 1);
+            SEARCH_STATS_ADD(search, first_move_cutoffs, legal_moves == 1);
+            SEARCH_TRACE_EVENT(search, TRACE_CUTOFF, depth, alpha, beta, score);
+            alpha = beta;
+            break;
+        }
+        if (score > alpha)
+            alpha = score;
+    }
+
+    // No legal moves: mated if in check, stalemate otherwise
+    if (legal_moves == 0 && search->error == ENGINE_OK && !search->stopped) {
+        int score = is_in_check(board) ? -KING_LOST_SCORE + (int) ply : 0;
+        if (score >= beta)
+            alpha = beta;
+        else if (score > alpha)
+            alpha = score;
+    }
+
+    release_board(&search->memory->boards, child);
+    reset_arena(arena, mark);
+    SEARCH_TRACE_EVENT(search, TRACE_EXIT, depth, alpha, beta, alpha);
+    return alpha;
+}
+
+
+// Depth must be at least 1. Returns the score from the side to move's
+// point of view, best_move is left untouched if there are no legal moves
+int search_board(Board* board, size_t depth, Move* best_move, Search* search)
+{
+    search->illegal_move = false;
+    search->nodes += 1;
+    SEARCH_TRACE_EVENT(search, TRACE_ENTER, depth, -SEARCH_INFINITY, SEARCH_INFINITY, 0);
+
+    Arena* arena = &search->memory->arena;
+    size_t mark = get_arena_mark(arena);
+    MoveArray* move_array = get_pseudomoves_from_board_in(arena, board);
+    Board* child = acquire_board(&search->memory->boards);
+    if (move_array == NULL || child == NULL) {
+        search->error = ENGINE_OUT_OF_MEMORY;
+        if (child != NULL)
+            release_board(&search->memory->boards, child);
+        reset_arena(arena, mark);
+        return 0;
+    }
+    SEARCH_STATS_ADD(search, generation_calls, 1);
+    SEARCH_STATS_ADD(search, moves_generated, move_array->count);
+    int alpha = -SEARCH_INFINITY;
+
+    size_t legal_moves = 0;
+    for (size_t i = 0; i < move_array->count; ++i) {
+        copy_board_into(child, board);
+        make_move(child, move_array->moves[i]);
+        int score = -negamax(child, depth - 1, 1, -SEARCH_INFINITY, -alpha, search);
+        if (search->error != ENGINE_OK || search->stopped)
+            break;
+        if (search->illegal_move) {
+            search->illegal_move = false;
+            continue;
+        }
+        legal_moves += 1;
+        if (score > alpha) {
+            alpha = score;
+            *best_move = *move_array->moves[i];
+        }
+    }
+    if (legal_moves == 0 && search->error == ENGINE_OK && !search->stopped)
+        alpha = is_in_check(board) ? -KING_LOST_SCORE : 0;
+
+    release_board(&search->memory->boards, child);
+    reset_arena(arena, mark);
+    SEARCH_TRACE_EVENT(search, TRACE_EXIT, depth, -SEARCH_INFINITY, SEARCH_INFINITY, alpha);
+    return alpha;
+}
+
+
+// Iterative deepening. Keeps the result of the deepest iteration that
+// finished, the first one always runs to the end whatever the limits.
+int search_with_limits(Board* board, SearchLimits* limits, Move* best_move, Search* search)
+{
+    size_t max_depth = limits->depth == 0 || limits->depth > MAX_SEARCH_DEPTH ? MAX_SEARCH_DEPTH : limits->depth;
+    double deadline = limits->time > 0.0 ? get_time() + limits->time : 0.0;
+    uint64_t max_nodes = limits->nodes > 0 ? search->nodes + limits->nodes : 0;
+
+    search->stopped = false;
+    search->max_nodes = 0;
+    search->deadline = 0.0;
+
+    int result = 0;
+    for (size_t depth = 1; depth <= max_depth; ++depth) {
+        Move move = *best_move;
+        int score = search_board(board, depth, &move, search);
+        if (search->error != ENGINE_OK || search->stopped)
+            break;
+        result = score;
+        *best_move = move;
+        if (ABS(score) >= MATE_SCORE_BOUND)
+            break;
+        if ((max_nodes != 0 && search->nodes >= max_nodes) || (deadline != 0.0 && get_time() >= deadline))
+            break;
+        search->max_nodes = max_nodes;
+        search->deadline = deadline;
+    }
+
+    search->stopped = false;
+    search->max_nodes = 0;
+    search->deadline = 0.0;
+    return result;
+}
+
+
+// Counts the leaf nodes of the legal move tree into nodes. Castling
+// isn't generated, so positions that can castle count fewer.
+ENGINE_ERROR perft(Board* board, size_t depth, ThreadMemory* memory, uint64_t* nodes)
+{
+    if (depth == 0) {
+        *nodes += 1;
+        return ENGINE_OK;
+    }
+
+    size_t mark = get_arena_mark(&memory->arena);
+    MoveArray* move_array = get_pseudomoves_from_board_in(&memory->arena, board);
+    if (move_array == NULL) {
+        reset_arena(&memory->arena, mark);
+        return ENGINE_OUT_OF_MEMORY;
+    }
+
+    Board* child = acquire_board(&memory->boards);
+    if (child == NULL) {
+        reset_arena(&memory->arena, mark);
+        return ENGINE_OUT_OF_MEMORY;
+    }
+    PIECE_INDEX king_index = board->turn == WHITE_TURN ? W_KING_I : B_KING_I;
+    ENGINE_ERROR result = ENGINE_OK;
+    for (size_t i = 0; i < move_array->count && result == ENGINE_OK; ++i) {
+        copy_board_into(child, board);
+        make_move(child, move_array->moves[i]);
+        if (is_square_attacked(child, child->pieces[king_index], child->turn))
+            continue;
+        if (depth == 1)
+            *nodes += 1;
+        else
+            result = perft(child, depth - 1, memory, nodes);
+    }
+    release_board(&memory->boards, child);
+    reset_arena(&memory->arena, mark);
+    return result;
+}
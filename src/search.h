@@ -0,0 +1,94 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "chess.h"
+#include "memory.h"
+#include "stats.h"
+
+
+/**
+ * Constants
+ */
+
+#define SEARCH_INFINITY (1000000)
+// Pseudomoves let kings be taken, losing the king is the worst possible score
+#define KING_LOST_SCORE (100000)
+
+#define MAX_SEARCH_DEPTH (64)
+// Mates score KING_LOST_SCORE less the plies to reach them, anything
+// past this bound is one
+#define MATE_SCORE_BOUND (KING_LOST_SCORE - MAX_SEARCH_DEPTH)
+// Reading the clock every node would cost more than the node
+#define TIME_CHECK_NODES (1024)
+
+
+/**
+ * Structs
+ */
+
+// Zero means no limit
+typedef struct {
+    size_t depth;
+    uint64_t nodes;
+    double time; // Seconds
+} SearchLimits;
+
+
+// memory must be set before searching. If it runs out, error is set and
+// the search unwinds, its results can't be trusted then.
+typedef struct {
+    ThreadMemory* memory;
+    ENGINE_ERROR error;
+    uint64_t nodes;
+    uint64_t max_nodes; // 0 for no limit
+    double deadline;    // get_time() value, 0 for no limit
+    bool stopped;       // A limit was hit, the last iteration is incomplete
+    bool illegal_move;  // The last child searched was reached by an illegal move
+#ifdef SEARCH_STATS
+    SearchStats stats;
+#endif
+#ifdef SEARCH_TRACE
+    SearchTrace* trace; // NULL to not trace
+#endif
+} Search;
+
+
+/**
+ * Functions
+ */
+
+double get_time(void);
+int evaluate_board_for_turn(Board* board);
+int negamax(Board* board, size_t depth, size_t ply, int alpha, int beta, Search* search);
+int search_board(Board* board, size_t depth, Move* best_move, Search* search);
+int search_with_limits(Board* board, SearchLimits* limits, Move* best_move, Search* search);
+ENGINE_ERROR perft(Board* board, size_t depth, ThreadMemory* memory, uint64_t* nodes);
+
+
+#endif // SEARCH_H
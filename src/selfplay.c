@@ -0,0 +1,335 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "attacks.h"
+#include "book.h"
+#include "selfplay.h"
+
+
+static bool has_only_kings(Board* board)
+{
+    return (get_all_occupied_squares(board) & ~(board->pieces[W_KING_I] | board->pieces[B_KING_I])) == 0ULL;
+}
+
+
+// Same position with the same side to move at least twice before
+static bool is_repetition(uint64_t* keys, size_t ply, size_t halfmove_clock)
+{
+    size_t repetitions = 0;
+    for (size_t i = 2; i <= halfmove_clock && i <= ply; i += 2) {
+        if (keys[ply - i] == keys[ply])
+            repetitions += 1;
+    }
+    return repetitions >= 2;
+}
+
+
+// Whether move keeps the mover's king out of attack, child is scratch space
+static bool is_legal_move(Board* board, Move* move, Board* child)
+{
+    copy_board_into(child, board);
+    make_move(child, move);
+    PIECE_INDEX king_index = board->turn == WHITE_TURN ? W_KING_I : B_KING_I;
+    return !is_square_attacked(child, child->pieces[king_index], child->turn);
+}
+
+
+// Keeps move if it's legal and otherwise takes the first legal one. found
+// is false if there are none, which is checkmate or stalemate.
+static ENGINE_ERROR find_legal_move(Board* board, ThreadMemory* memory, Move* move, bool* found)
+{
+    Board* child = acquire_board(&memory->boards);
+    if (child == NULL)
+        return ENGINE_OUT_OF_MEMORY;
+
+    ENGINE_ERROR result = ENGINE_OK;
+    *found = move->next_position != 0ULL && is_legal_move(board, move, child);
+    if (!*found) {
+        size_t mark = get_arena_mark(&memory->arena);
+        MoveArray* move_array = get_pseudomoves_from_board_in(&memory->arena, board);
+        if (move_array == NULL)
+            result = ENGINE_OUT_OF_MEMORY;
+        for (size_t i = 0; move_array != NULL && i < move_array->count && !*found; ++i) {
+            if (is_legal_move(board, move_array->moves[i], child)) {
+                *move = *move_array->moves[i];
+                *found = true;
+            }
+        }
+        reset_arena(&memory->arena, mark);
+    }
+
+    release_board(&memory->boards, child);
+    return result;
+}
+
+
+// Plays until a result, reading the game's board from memory's pool. The
+// FEN must be valid.
+ENGINE_ERROR play_game(Game* game, const char* fen, SearchLimits* white, SearchLimits* black, ThreadMemory* memory)
+{
+    Board* initial_board = create_board_from_fen(fen);
+    Board* board = acquire_board(&memory->boards);
+    if (initial_board == NULL || board == NULL) {
+        if (initial_board != NULL)
+            destroy_board(initial_board);
+        if (board != NULL)
+            release_board(&memory->boards, board);
+        return ENGINE_OUT_OF_MEMORY;
+    }
+    copy_board_into(board, initial_board);
+    destroy_board(initial_board);
+
+    snprintf(game->fen, sizeof(game->fen), "%s", fen);
+    game->ply_count = 0;
+    game->result = GAME_DRAW;
+    game->reason = "Move limit";
+    game->nodes = 0;
+
+    uint64_t keys[MAX_GAME_PLIES + 1];
+    keys[0] = get_book_key(board);
+    size_t halfmove_clock = 0;
+    ENGINE_ERROR error = ENGINE_OK;
+
+    while (game->ply_count < MAX_GAME_PLIES) {
+        bool white_to_move = board->turn == WHITE_TURN;
+        GAME_RESULT loss = white_to_move ? GAME_BLACK_WINS : GAME_WHITE_WINS;
+
+        Search search = { 0 };
+        search.memory = memory;
+        Move move;
+        move.next_position = 0ULL;
+        int score = search_with_limits(board, white_to_move ? white : black, &move, &search);
+        game->nodes += search.nodes;
+        if (search.error != ENGINE_OK) {
+            error = search.error;
+            break;
+        }
+
+        // Losing the king within the horizon isn't mate yet, only having
+        // no legal move is
+        if (move.next_position == 0ULL || score <= -MATE_SCORE_BOUND) {
+            bool found;
+            error = find_legal_move(board, memory, &move, &found);
+            if (error != ENGINE_OK)
+                break;
+            if (!found) {
+                bool in_check = is_in_check(board);
+                game->result = in_check ? loss : GAME_DRAW;
+                game->reason = in_check ? "Checkmate" : "Stalemate";
+                break;
+            }
+        }
+
+        PIECE_INDEX captured;
+        if (get_piece_type_at(board, move.next_position, &captured) || move.piece_type == W_PAWN_I || move.piece_type == B_PAWN_I)
+            halfmove_clock = 0;
+        else
+            halfmove_clock += 1;
+
+        make_move(board, &move);
+        game->scores[game->ply_count] = score;
+        game->moves[game->ply_count++] = move;
+        keys[game->ply_count] = get_book_key(board);
+
+        // Only happens if a limit kept the engine from seeing it
+        if (board->pieces[white_to_move ? B_KING_I : W_KING_I] == 0ULL) {
+            game->result = white_to_move ? GAME_WHITE_WINS : GAME_BLACK_WINS;
+            game->reason = "King captured";
+            break;
+        }
+        if (halfmove_clock >= FIFTY_MOVE_PLIES) {
+            game->reason = "Fifty moves";
+            break;
+        }
+        if (is_repetition(keys, game->ply_count, halfmove_clock)) {
+            game->reason = "Repetition";
+            break;
+        }
+        if (has_only_kings(board)) {
+            game->reason = "Insufficient material";
+            break;
+        }
+    }
+
+    release_board(&memory->boards, board);
+    return error;
+}
+
+
+const char* get_result_string(GAME_RESULT result)
+{
+    switch (result) {
+    case GAME_WHITE_WINS:
+        return "1-0";
+    case GAME_BLACK_WINS:
+        return "0-1";
+    default:
+        return "1/2-1/2";
+    }
+}
+
+
+ENGINE_ERROR write_game_pgn(FILE* file, Game* game, const char* white, const char* black, size_t round, ThreadMemory* memory)
+{
+    Board* initial_board = create_board_from_fen(game->fen);
+    Board* board = acquire_board(&memory->boards);
+    if (initial_board == NULL || board == NULL) {
+        if (initial_board != NULL)
+            destroy_board(initial_board);
+        if (board != NULL)
+            release_board(&memory->boards, board);
+        return ENGINE_OUT_OF_MEMORY;
+    }
+    copy_board_into(board, initial_board);
+    destroy_board(initial_board);
+
+    const char* result = get_result_string(game->result);
+    fprintf(file, "[Event \"mini-a-b self-play\"]\n");
+    fprintf(file, "[Site \"?\"]\n");
+    fprintf(file, "[Date \"????.??.??\"]\n");
+    fprintf(file, "[Round \"%zu\"]\n", round);
+    fprintf(file, "[White \"%s\"]\n", white);
+    fprintf(file, "[Black \"%s\"]\n", black);
+    fprintf(file, "[Result \"%s\"]\n", result);
+    if (strcmp(game->fen, STARTING_FEN) != 0) {
+        fprintf(file, "[SetUp \"1\"]\n");
+        fprintf(file, "[FEN \"%s 0 1\"]\n", game->fen);
+    }
+    fprintf(file, "[Termination \"%s\"]\n\n", game->reason);
+
+    ENGINE_ERROR error = ENGINE_OK;
+    size_t line_length = 0;
+    size_t black_started = board->turn == BLACK_TURN;
+    for (size_t i = 0; i < game->ply_count; ++i) {
+        char text[MAX_SAN_LENGTH + 16];
+        size_t length = 0;
+        if (board->turn == WHITE_TURN)
+            length += (size_t) sprintf(text, "%zu. ", (i + black_started) / 2 + 1);
+        else if (i == 0)
+            length += (size_t) sprintf(text, "1... ");
+
+        size_t mark = get_arena_mark(&memory->arena);
+        MoveArray* move_array = get_pseudomoves_from_board_in(&memory->arena, board);
+        if (move_array == NULL) {
+            error = ENGINE_OUT_OF_MEMORY;
+            reset_arena(&memory->arena, mark);
+            break;
+        }
+        get_move_san(board, &game->moves[i], move_array, text + length);
+        reset_arena(&memory->arena, mark);
+        make_move(board, &game->moves[i]);
+
+        length = strlen(text);
+        if (line_length + length + 1 > 79) {
+            fputc('\n', file);
+            line_length = 0;
+        } else if (line_length > 0) {
+            fputc(' ', file);
+            line_length += 1;
+        }
+        fputs(text, file);
+        line_length += length;
+    }
+    fprintf(file, "%s%s\n\n", line_length > 0 ? " " : "", result);
+
+    release_board(&memory->boards, board);
+    return error;
+}
+
+
+double get_match_score(MatchResults* results)
+{
+    uint64_t games = results->wins + results->draws + results->losses;
+    if (games == 0)
+        return 0.5;
+    return ((double) results->wins + 0.5 * (double) results->draws) / (double) games;
+}
+
+
+static double score_to_elo(double score)
+{
+    if (score <= 0.0)
+        return -INFINITY;
+    if (score >= 1.0)
+        return INFINITY;
+    return -400.0 * log10(1.0 / score - 1.0);
+}
+
+
+static double elo_to_score(double elo)
+{
+    return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+}
+
+
+// Variance of a single game's score
+static double get_score_variance(MatchResults* results)
+{
+    uint64_t games = results->wins + results->draws + results->losses;
+    if (games == 0)
+        return 0.0;
+    double score = get_match_score(results);
+    double variance = (double) results->wins * (1.0 - score) * (1.0 - score)
+        + (double) results->draws * (0.5 - score) * (0.5 - score)
+        + (double) results->losses * score * score;
+    return variance / (double) games;
+}
+
+
+double get_elo(MatchResults* results)
+{
+    return score_to_elo(get_match_score(results));
+}
+
+
+// Half the width of the 95% confidence interval
+double get_elo_error(MatchResults* results)
+{
+    uint64_t games = results->wins + results->draws + results->losses;
+    if (games == 0)
+        return INFINITY;
+    double score = get_match_score(results);
+    if (score <= 0.0 || score >= 1.0)
+        return INFINITY;
+    double margin = 1.959964 * sqrt(get_score_variance(results) / (double) games);
+    return (score_to_elo(score + margin) - score_to_elo(score - margin)) / 2.0;
+}
+
+
+// Log likelihood ratio of elo1 against elo0, using the normal
+// approximation of the trinomial distribution (GSPRT)
+double get_sprt_llr(MatchResults* results, double elo0, double elo1)
+{
+    uint64_t games = results->wins + results->draws + results->losses;
+    double variance = get_score_variance(results);
+    if (games == 0 || variance == 0.0)
+        return 0.0;
+    double score = get_match_score(results);
+    double score0 = elo_to_score(elo0);
+    double score1 = elo_to_score(elo1);
+    return (double) games * (score1 - score0) * (2.0 * score - score0 - score1) / (2.0 * variance);
+}
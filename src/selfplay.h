@@ -0,0 +1,98 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "chess.h"
+#include "memory.h"
+#include "search.h"
+
+
+/**
+ * Constants
+ */
+
+#define STARTING_FEN ("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -")
+#define MAX_FEN_LENGTH (128)
+
+// Games still going after this many plies are drawn
+#define MAX_GAME_PLIES (400)
+#define FIFTY_MOVE_PLIES (100)
+
+// The search's boards plus the game board and one to look for checks
+#define SELFPLAY_MAX_DEPTH (MAX_SEARCH_DEPTH + 2)
+
+
+/**
+ * Enums
+ */
+
+typedef enum {
+    GAME_WHITE_WINS = 0,
+    GAME_BLACK_WINS = 1,
+    GAME_DRAW       = 2,
+} GAME_RESULT;
+
+
+/**
+ * Structs
+ */
+
+typedef struct {
+    char fen[MAX_FEN_LENGTH];
+    Move moves[MAX_GAME_PLIES];
+    int scores[MAX_GAME_PLIES]; // Search score before each move, from the mover's side
+    size_t ply_count;
+    GAME_RESULT result;
+    const char* reason;
+    uint64_t nodes;
+} Game;
+
+
+// Counted from the first engine's side
+typedef struct {
+    uint64_t wins;
+    uint64_t draws;
+    uint64_t losses;
+} MatchResults;
+
+
+/**
+ * Functions
+ */
+
+ENGINE_ERROR play_game(Game* game, const char* fen, SearchLimits* white, SearchLimits* black, ThreadMemory* memory);
+ENGINE_ERROR write_game_pgn(FILE* file, Game* game, const char* white, const char* black, size_t round, ThreadMemory* memory);
+const char* get_result_string(GAME_RESULT result);
+double get_match_score(MatchResults* results);
+double get_elo(MatchResults* results);
+double get_elo_error(MatchResults* results);
+double get_sprt_llr(MatchResults* results, double elo0, double elo1);
+
+
+#endif // SELFPLAY_H
@@ -0,0 +1,134 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stats.h"
+
+
+static const char* TRACE_EVENT_NAMES[] = { "enter", "leaf", "cutoff", "exit" };
+
+
+// For merging the counters of several threads once they are done
+void add_search_stats(SearchStats* total, SearchStats* stats)
+{
+    total->leaf_nodes         += stats->leaf_nodes;
+    total->king_captures      += stats->king_captures;
+    total->beta_cutoffs       += stats->beta_cutoffs;
+    total->first_move_cutoffs += stats->first_move_cutoffs;
+    total->generation_calls   += stats->generation_calls;
+    total->moves_generated    += stats->moves_generated;
+}
+
+
+void print_search_stats(FILE* file, uint64_t nodes, SearchStats* stats)
+{
+    double first_move_rate = stats->beta_cutoffs > 0
+        ? 100.0 * (double) stats->first_move_cutoffs / (double) stats->beta_cutoffs
+        : 0.0;
+    double branching = stats->generation_calls > 0
+        ? (double) stats->moves_generated / (double) stats->generation_calls
+        : 0.0;
+    fprintf(file, "Nodes:              %llu\n", (unsigned long long) nodes);
+    fprintf(file, "Leaf nodes:         %llu\n", (unsigned long long) stats->leaf_nodes);
+    fprintf(file, "King captures:      %llu\n", (unsigned long long) stats->king_captures);
+    fprintf(file, "Beta cutoffs:       %llu\n", (unsigned long long) stats->beta_cutoffs);
+    fprintf(file, "First move cutoffs: %llu (%.1f%%)\n", (unsigned long long) stats->first_move_cutoffs, first_move_rate);
+    fprintf(file, "Generation calls:   %llu\n", (unsigned long long) stats->generation_calls);
+    fprintf(file, "Moves generated:    %llu (%.1f per call)\n", (unsigned long long) stats->moves_generated, branching);
+}
+
+
+// A trace needs room for at least one event
+SearchTrace* create_search_trace(size_t capacity)
+{
+    if (capacity == 0)
+        return NULL;
+    SearchTrace* result = (SearchTrace*) malloc(sizeof(SearchTrace));
+    if (result == NULL)
+        return NULL;
+    result->events = (TraceEvent*) malloc(sizeof(TraceEvent) * capacity);
+    if (result->events == NULL) {
+        free(result);
+        return NULL;
+    }
+    result->capacity = capacity;
+    result->next = 0;
+    result->recorded = 0;
+    return result;
+}
+
+
+void destroy_search_trace(SearchTrace* trace)
+{
+    free(trace->events);
+    free(trace);
+}
+
+
+void record_trace_event(SearchTrace* trace, uint64_t node, TRACE_EVENT_TYPE type, size_t depth, int alpha, int beta, int score)
+{
+    TraceEvent* event = &trace->events[trace->next];
+    event->node = node;
+    event->type = type;
+    event->depth = (uint32_t) depth;
+    event->alpha = alpha;
+    event->beta = beta;
+    event->score = score;
+    trace->next = trace->next + 1 == trace->capacity ? 0 : trace->next + 1;
+    trace->recorded += 1;
+}
+
+
+size_t get_trace_event_count(SearchTrace* trace)
+{
+    return trace->recorded < trace->capacity ? (size_t) trace->recorded : trace->capacity;
+}
+
+
+// Index 0 is the oldest event still in the buffer
+TraceEvent* get_trace_event(SearchTrace* trace, size_t index)
+{
+    size_t first = trace->recorded < trace->capacity ? 0 : trace->next;
+    return &trace->events[(first + index) % trace->capacity];
+}
+
+
+// One event per line: node type depth alpha beta score
+bool dump_search_trace(SearchTrace* trace, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not create %s\n", path);
+        return false;
+    }
+    size_t count = get_trace_event_count(trace);
+    fprintf(file, "# %llu events recorded, last %zu kept\n", (unsigned long long) trace->recorded, count);
+    fprintf(file, "# node type depth alpha beta score\n");
+    for (size_t i = 0; i < count; ++i) {
+        TraceEvent* event = get_trace_event(trace, i);
+        fprintf(file, "%llu %s %u %d %d %d\n", (unsigned long long) event->node, TRACE_EVENT_NAMES[event->type],
+                event->depth, event->alpha, event->beta, event->score);
+    }
+    return fclose(file) == 0;
+}
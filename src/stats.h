@@ -0,0 +1,118 @@
+// Copyright 2024 Alejandro Fernández <aleferu888@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/**
+ * Compile time switches
+ *
+ * -DSEARCH_STATS counts what the search does into Search.stats
+ * -DSEARCH_TRACE records search tree events into Search.trace, if set
+ *
+ * Without them the hooks expand to nothing.
+ */
+
+#ifdef SEARCH_STATS
+#define SEARCH_STATS_ADD(search, field, n) ((search)->stats.field += (uint64_t) (n))
+#else
+#define SEARCH_STATS_ADD(search, field, n) ((void) 0)
+#endif
+
+#ifdef SEARCH_TRACE
+#define SEARCH_TRACE_EVENT(search, type, depth, alpha, beta, score)                         \
+    do {                                                                                    \
+        if ((search)->trace != NULL)                                                        \
+            record_trace_event((search)->trace, (search)->nodes, type, depth, alpha, beta, score); \
+    } while (0)
+#else
+#define SEARCH_TRACE_EVENT(search, type, depth, alpha, beta, score) ((void) 0)
+#endif
+
+
+/**
+ * Enums
+ */
+
+typedef enum {
+    TRACE_ENTER  = 0,
+    TRACE_LEAF   = 1,
+    TRACE_CUTOFF = 2,
+    TRACE_EXIT   = 3,
+} TRACE_EVENT_TYPE;
+
+
+/**
+ * Structs
+ */
+
+// One per search, so every thread counts into its own copy
+typedef struct {
+    uint64_t leaf_nodes;
+    uint64_t king_captures;
+    uint64_t beta_cutoffs;
+    uint64_t first_move_cutoffs;
+    uint64_t generation_calls;
+    uint64_t moves_generated;
+} SearchStats;
+
+
+typedef struct {
+    uint64_t node;
+    TRACE_EVENT_TYPE type;
+    uint32_t depth;
+    int alpha;
+    int beta;
+    int score;
+} TraceEvent;
+
+
+// Ring buffer, once full the oldest events get overwritten
+typedef struct {
+    TraceEvent* events;
+    size_t capacity;
+    size_t next;
+    uint64_t recorded;
+} SearchTrace;
+
+
+/**
+ * Functions
+ */
+
+void add_search_stats(SearchStats* total, SearchStats* stats);
+void print_search_stats(FILE* file, uint64_t nodes, SearchStats* stats);
+SearchTrace* create_search_trace(size_t capacity); // NULL if out of memory
+void destroy_search_trace(SearchTrace* trace);
+void record_trace_event(SearchTrace* trace, uint64_t node, TRACE_EVENT_TYPE type, size_t depth, int alpha, int beta, int score);
+size_t get_trace_event_count(SearchTrace* trace);
+TraceEvent* get_trace_event(SearchTrace* trace, size_t index);
+bool dump_search_trace(SearchTrace* trace, const char* path);
+
+
+#endif // STATS_H
@@ -1,7 +1,17 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
+#include <unistd.h>
 
+#include "attacks.h"
+#include "book.h"
+#include "arena.h"
 #include "chess.h"
+#include "dataset.h"
+#include "memory.h"
+#include "search.h"
+#include "selfplay.h"
 
 
 void test_evaluate_board(Board* board)
@@ -61,6 +71,491 @@ void test_is_piece_in(void)
 }
 
 
+void test_create_board_from_fen(Board* board)
+{
+    Board* fen_board = create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    assert(fen_board != NULL);
+    for (size_t i = 0; i < N_PIECES; ++i) {
+        assert(fen_board->pieces[i] == board->pieces[i]);
+    }
+    assert(fen_board->turn == WHITE_TURN);
+    assert(fen_board->castling_rights == 0x0F);
+    assert(!fen_board->en_passant);
+    destroy_board(fen_board);
+
+    fen_board = create_board_from_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b Kq e3");
+    assert(fen_board != NULL);
+    assert(fen_board->turn == BLACK_TURN);
+    assert(fen_board->castling_rights == (W_KINGSIDE_CASTLE | B_QUEENSIDE_CASTLE));
+    assert(fen_board->en_passant);
+    assert(fen_board->en_passant_square == get_square_position(3, 5));
+    destroy_board(fen_board);
+
+    assert(create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq -") == NULL);
+    assert(create_board_from_fen("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -") == NULL);
+}
+
+
+void test_book(Board* board)
+{
+    Move e4, d4;
+    assert(parse_move(board, "e2e4", &e4));
+    assert(parse_move(board, "d2d4", &d4));
+    assert(e4.piece_type == W_PAWN_I);
+
+    // Keys from the Polyglot book format reference
+    uint64_t key = get_book_key(board);
+    assert(key == 0x463B96181691FC9CULL);
+    Board* line_board = copy_board(board);
+    const char* line[6] = { "e2e4", "d7d5", "e4e5", "f7f5", "e1e2", "e8f7" };
+    const uint64_t line_keys[6] = {
+        0x823C9B50FD114196ULL, 0x0756B94461C50FB0ULL, 0x662FAFB965DB29D4ULL,
+        0x22A48B5A8E47FF78ULL, 0x652A607CA3F242C1ULL, 0x00FDD303C946BDD9ULL,
+    };
+    for (size_t i = 0; i < 6; ++i) {
+        Move move;
+        assert(parse_move(line_board, line[i], &move));
+        make_move(line_board, &move);
+        assert(get_book_key(line_board) == line_keys[i]);
+    }
+    destroy_board(line_board);
+
+    Board* black_board = create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq -");
+    assert(key != get_book_key(black_board));
+
+    BookEntry entries[4] = {
+        { get_book_key(black_board), encode_book_move(&e4), 1, 0 },
+        { key, encode_book_move(&d4), 2, 0 },
+        { key, encode_book_move(&e4), 0, 0 },
+        { key, encode_book_move(&d4), 3, 0 },
+    };
+    size_t count = 4;
+    sort_book_entries(entries, &count);
+    assert(count == 3);
+    destroy_board(black_board);
+
+    char path[] = "/tmp/mini-a-b-book-XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    assert(write_book(path, entries, count));
+
+    Book* book = open_book(path);
+    assert(book != NULL);
+    assert(book->count == 3);
+    size_t first = find_book_entry(book, key);
+    assert(first < book->count);
+    assert(get_book_entry(book, first).key == key);
+    assert(find_book_entry(book, key ^ 1ULL) == book->count);
+
+    // e2e4 has no weight, so d2d4 is always chosen
+    uint64_t random_state = 1ULL;
+    for (size_t i = 0; i < 16; ++i) {
+        Move move;
+        assert(get_book_move(book, board, &random_state, &move));
+        assert(move.piece_type == W_PAWN_I);
+        assert(move.previous_position == d4.previous_position);
+        assert(move.next_position == d4.next_position);
+    }
+
+    close_book(book);
+    unlink(path);
+}
+
+
+void test_make_move(Board* board)
+{
+    Board* child = copy_board(board);
+    Move move;
+    assert(parse_move(child, "e2e4", &move));
+    make_move(child, &move);
+    assert(child->turn == BLACK_TURN);
+    assert(child->en_passant);
+    assert(child->en_passant_square == get_square_position(3, 5));
+    assert(child->pieces[W_PAWN_I] == ((W_PAWNS_S & ~get_square_position(2, 5)) | get_square_position(4, 5)));
+    assert(board->pieces[W_PAWN_I] == W_PAWNS_S);
+    destroy_board(child);
+
+    // Pawn steps need empty squares, the double step the one in between too
+    child = create_board_from_fen("4k3/4p3/3P1n2/8/8/4nn2/3pP3/4K3 b - -");
+    uint64_t white = get_white_occupied_squares(child);
+    uint64_t black = get_black_occupied_squares(child);
+    assert(get_pseudomoves_from_white_pawn(child, get_square_position(2, 5), white, black) == get_square_position(3, 6));
+    assert(get_pseudomoves_from_black_pawn(child, get_square_position(7, 5), black, white) == (get_square_position(6, 5) | get_square_position(5, 5) | get_square_position(6, 4)));
+    assert(get_pseudomoves_from_black_pawn(child, get_square_position(2, 4), black, white) == (get_square_position(1, 4) | get_square_position(1, 5)));
+    // and promote to a queen
+    assert(parse_move(child, "d2d1", &move));
+    make_move(child, &move);
+    assert(child->pieces[B_PAWN_I] == get_square_position(7, 5));
+    assert(child->pieces[B_QUEEN_I] == get_square_position(1, 4));
+    destroy_board(child);
+
+    child = create_board_from_fen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq -");
+    assert(parse_move(child, "e1g1", &move));
+    make_move(child, &move);
+    assert(child->pieces[W_KING_I] == get_square_position(1, 7));
+    assert(child->pieces[W_ROOK_I] == (get_square_position(1, 1) | get_square_position(1, 6)));
+    assert(child->castling_rights == (B_KINGSIDE_CASTLE | B_QUEENSIDE_CASTLE));
+    destroy_board(child);
+
+    EngineMemory memory;
+    MemoryConfig config = get_memory_config(1, 4);
+    assert(create_engine_memory(&memory, &config) == ENGINE_OK);
+    ThreadMemory* thread_memory = get_thread_memory(&memory, 0);
+    uint64_t nodes = 0;
+    assert(perft(board, 0, thread_memory, &nodes) == ENGINE_OK);
+    assert(nodes == 1);
+    MoveArray* move_array = get_pseudomoves_from_board(board);
+    assert(move_array->count == 20);
+    destroy_move_array(move_array);
+
+    // Reference counts, none of them need castling within these depths
+    const char* fens[3] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq -",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    };
+    uint64_t expected[3][4] = {
+        { 20, 400, 8902, 197281 },
+        { 20, 400, 8902, 197281 },
+        { 14, 191, 2812, 43238 },
+    };
+    for (size_t i = 0; i < 3; ++i) {
+        Board* position = create_board_from_fen(fens[i]);
+        for (size_t depth = 1; depth <= 4; ++depth) {
+            nodes = 0;
+            assert(perft(position, depth, thread_memory, &nodes) == ENGINE_OK);
+            assert(nodes == expected[i][depth - 1]);
+        }
+        destroy_board(position);
+    }
+    // Not enough boards for depth 6
+    assert(perft(board, 6, thread_memory, &nodes) == ENGINE_OUT_OF_MEMORY);
+    destroy_engine_memory(&memory);
+}
+
+
+void test_search_board(void)
+{
+    Board* board = create_board_from_fen("4k3/8/8/8/8/8/8/4R1K1 w - -");
+    EngineMemory memory;
+    MemoryConfig config = get_memory_config(1, 4);
+    assert(create_engine_memory(&memory, &config) == ENGINE_OK);
+    Search search = { 0 };
+    search.memory = get_thread_memory(&memory, 0);
+    Move best_move;
+    int score = search_board(board, 2, &best_move, &search);
+    assert(search.error == ENGINE_OK);
+    assert(score == KING_LOST_SCORE - 1);
+    assert(best_move.piece_type == W_ROOK_I);
+    assert(best_move.next_position == B_KING_S);
+    assert(search.nodes > 1);
+    // Everything went back to the arena and the pool
+    assert(get_arena_mark(&search.memory->arena) == 0);
+    assert(search.memory->boards.free_slots == &search.memory->boards.slots[0]);
+    destroy_board(board);
+
+    // Every king move hangs the king: mate in check, a draw otherwise
+    board = create_board_from_fen("7k/6Q1/6K1/8/8/8/8/8 b - -");
+    best_move.next_position = 0ULL;
+    assert(search_board(board, 2, &best_move, &search) == -KING_LOST_SCORE);
+    assert(best_move.next_position == 0ULL);
+    destroy_board(board);
+    board = create_board_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - -");
+    assert(search_board(board, 2, &best_move, &search) == 0);
+    assert(best_move.next_position == 0ULL);
+    destroy_board(board);
+
+    // Ra8 mates right away, slower mates score less
+    board = create_board_from_fen("7k/8/6K1/8/8/8/8/R7 w - -");
+    assert(search_board(board, 4, &best_move, &search) == KING_LOST_SCORE - 1);
+    assert(best_move.next_position == get_square_position(8, 1));
+    destroy_board(board);
+    destroy_engine_memory(&memory);
+}
+
+
+void test_arena(void)
+{
+    unsigned char memory[256];
+    Arena arena;
+    init_arena(&arena, memory, sizeof(memory));
+    void* first = arena_alloc(&arena, 1);
+    size_t mark = get_arena_mark(&arena);
+    void* second = arena_alloc(&arena, 1);
+    assert(first == memory);
+    assert((size_t) ((unsigned char*) second - memory) == ARENA_ALIGNMENT);
+    assert(arena_alloc(&arena, sizeof(memory)) == NULL);
+    reset_arena(&arena, mark);
+    assert(arena_alloc(&arena, 1) == second);
+
+    Board* board = create_default_board();
+    BoardSlot slots[2];
+    BoardPool pool;
+    init_board_pool(&pool, slots, 2);
+    Board* a = acquire_board(&pool);
+    Board* b = acquire_board(&pool);
+    assert(a != NULL && b != NULL && a != b);
+    assert(acquire_board(&pool) == NULL);
+    copy_board_into(b, board);
+    copy_board_into(a, b);
+    assert(a->pieces != b->pieces);
+    assert(memcmp(a->pieces, board->pieces, sizeof(uint64_t) * N_PIECES) == 0);
+    release_board(&pool, b);
+    assert(acquire_board(&pool) == b);
+
+    // No two threads share a cache line
+    EngineMemory engine_memory;
+    MemoryConfig config = get_memory_config(2, 2);
+    assert(create_engine_memory(&engine_memory, &config) == ENGINE_OK);
+    uintptr_t first_thread = (uintptr_t) get_thread_memory(&engine_memory, 0);
+    uintptr_t second_thread = (uintptr_t) get_thread_memory(&engine_memory, 1);
+    assert(first_thread % THREAD_MEMORY_ALIGNMENT == 0);
+    assert(second_thread - first_thread >= THREAD_MEMORY_ALIGNMENT);
+    assert(second_thread % THREAD_MEMORY_ALIGNMENT == 0);
+    destroy_engine_memory(&engine_memory);
+
+    MoveArray* heap_moves = get_pseudomoves_from_board(board);
+    init_arena(&arena, memory, sizeof(memory));
+    assert(get_pseudomoves_from_board_in(&arena, board) == NULL);
+    destroy_move_array(heap_moves);
+    destroy_board(board);
+}
+
+
+void test_search_trace(void)
+{
+    assert(create_search_trace(0) == NULL);
+    SearchTrace* trace = create_search_trace(4);
+    for (size_t i = 0; i < 3; ++i) {
+        record_trace_event(trace, i, TRACE_ENTER, 1, 0, 0, 0);
+    }
+    assert(get_trace_event_count(trace) == 3);
+    assert(get_trace_event(trace, 0)->node == 0);
+
+    // Wraps around and keeps the last four
+    for (size_t i = 3; i < 6; ++i) {
+        record_trace_event(trace, i, TRACE_LEAF, 0, 0, 0, (int) i);
+    }
+    assert(get_trace_event_count(trace) == 4);
+    assert(get_trace_event(trace, 0)->node == 2);
+    assert(get_trace_event(trace, 3)->node == 5);
+    assert(get_trace_event(trace, 3)->score == 5);
+    destroy_search_trace(trace);
+
+    SearchStats total = { 0 };
+    SearchStats stats = { 1, 2, 3, 4, 5, 6 };
+    add_search_stats(&total, &stats);
+    add_search_stats(&total, &stats);
+    assert(total.leaf_nodes == 2);
+    assert(total.moves_generated == 12);
+}
+
+
+void test_selfplay(void)
+{
+    MatchResults results = { 10, 20, 10 };
+    assert(get_match_score(&results) == 0.5);
+    assert(get_elo(&results) == 0.0);
+    assert(get_elo_error(&results) > 0.0);
+    MatchResults winning = { 60, 20, 20 };
+    assert(get_elo(&winning) > 0.0);
+    assert(get_sprt_llr(&winning, 0.0, 10.0) > 0.0);
+    assert(get_sprt_llr(&winning, 0.0, 10.0) > get_sprt_llr(&results, 0.0, 10.0));
+
+    EngineMemory memory;
+    MemoryConfig config = get_memory_config(1, SELFPLAY_MAX_DEPTH);
+    assert(create_engine_memory(&memory, &config) == ENGINE_OK);
+    ThreadMemory* thread_memory = get_thread_memory(&memory, 0);
+
+    // Both rooks can go to d1
+    Board* board = create_board_from_fen("4k3/8/8/8/8/8/4K3/R6R w - -");
+    assert(!is_in_check(board));
+    MoveArray* move_array = get_pseudomoves_from_board(board);
+    Move move;
+    char san[MAX_SAN_LENGTH];
+    assert(parse_move(board, "a1a2", &move));
+    get_move_san(board, &move, move_array, san);
+    assert(strcmp(san, "Ra2") == 0);
+    assert(parse_move(board, "h1d1", &move));
+    get_move_san(board, &move, move_array, san);
+    assert(strcmp(san, "Rhd1") == 0);
+    Move parsed;
+    assert(parse_san_move(board, "Rhd1+", move_array, &parsed));
+    assert(parsed.previous_position == move.previous_position && parsed.next_position == move.next_position);
+    assert(!parse_san_move(board, "Rd1", move_array, &parsed));
+    assert(!parse_san_move(board, "h1d1", move_array, &parsed));
+    destroy_move_array(move_array);
+    destroy_board(board);
+
+    board = create_board_from_fen("r3k2r/8/8/8/8/8/8/R3K2R b Qk -");
+    move_array = get_pseudomoves_from_board(board);
+    assert(parse_san_move(board, "0-0", move_array, &parsed));
+    assert(parsed.piece_type == B_KING_I && parsed.next_position == get_square_position(8, 7));
+    assert(!parse_san_move(board, "O-O-O", move_array, &parsed));
+    destroy_move_array(move_array);
+    destroy_board(board);
+
+    board = create_board_from_fen("4k3/8/8/8/8/8/1p6/R3K3 b - -");
+    move_array = get_pseudomoves_from_board(board);
+    assert(parse_move(board, "b2a1", &move));
+    get_move_san(board, &move, move_array, san);
+    assert(strcmp(san, "bxa1=Q") == 0);
+    assert(parse_san_move(board, "b1=Q+", move_array, &parsed));
+    assert(parsed.next_position == get_square_position(1, 2));
+    assert(!parse_san_move(board, "b1", move_array, &parsed));
+    destroy_move_array(move_array);
+    destroy_board(board);
+
+    // White takes the king right away
+    SearchLimits limits = { 2, 0, 0.0 };
+    Game* game = malloc(sizeof(Game));
+    assert(play_game(game, "4k3/8/8/8/8/8/8/4R1K1 w - -", &limits, &limits, thread_memory) == ENGINE_OK);
+    assert(game->result == GAME_WHITE_WINS);
+    assert(game->ply_count == 1);
+
+    // Black sees the king falling within the horizon but still has moves
+    limits.depth = 4;
+    assert(play_game(game, "7k/8/5K2/8/8/8/8/6R1 b - -", &limits, &limits, thread_memory) == ENGINE_OK);
+    assert(game->ply_count > 2);
+    assert(game->result == GAME_WHITE_WINS);
+    assert(strcmp(game->reason, "Stalemate") != 0);
+
+    // No legal move and no check
+    assert(play_game(game, "7k/5Q2/6K1/8/8/8/8/8 b - -", &limits, &limits, thread_memory) == ENGINE_OK);
+    assert(game->ply_count == 0);
+    assert(game->result == GAME_DRAW);
+    assert(strcmp(game->reason, "Stalemate") == 0);
+
+    // Move numbers when black moves first
+    const char* fen = "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3";
+    const char* moves[4] = { "e7e6", "f2f3", "h7h6", "h2h3" };
+    snprintf(game->fen, sizeof(game->fen), "%s", fen);
+    board = create_board_from_fen(fen);
+    for (size_t i = 0; i < 4; ++i) {
+        assert(parse_move(board, moves[i], &game->moves[i]));
+        make_move(board, &game->moves[i]);
+    }
+    destroy_board(board);
+    game->ply_count = 4;
+    game->result = GAME_DRAW;
+    game->reason = "Test";
+    FILE* pgn = tmpfile();
+    assert(pgn != NULL);
+    assert(write_game_pgn(pgn, game, "A", "B", 1, thread_memory) == ENGINE_OK);
+    char text[1024];
+    rewind(pgn);
+    size_t text_length = fread(text, 1, sizeof(text) - 1, pgn);
+    text[text_length] = '\0';
+    assert(strstr(text, "1... e6 2. f3 h6 3. h3 1/2-1/2") != NULL);
+    fclose(pgn);
+    free(game);
+
+    destroy_engine_memory(&memory);
+}
+
+
+void test_packed_positions(Board* board)
+{
+    Board* ep_board = create_board_from_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b Kq e3");
+    Board* unpacked = copy_board(board);
+    PackedPosition packed;
+    int score;
+    int result;
+
+    assert(pack_position(ep_board, 40000, -1, &packed));
+    assert(unpack_position(&packed, unpacked, &score, &result));
+    for (size_t i = 0; i < N_PIECES; ++i) {
+        assert(unpacked->pieces[i] == ep_board->pieces[i]);
+    }
+    assert(unpacked->turn == BLACK_TURN);
+    assert(unpacked->castling_rights == ep_board->castling_rights);
+    assert(unpacked->en_passant);
+    assert(unpacked->en_passant_square == ep_board->en_passant_square);
+    assert(score == PACKED_SCORE_MAX);
+    assert(result == -1);
+
+    char path[] = "/tmp/mini-a-b-positions-XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    // Small buffer so that it gets flushed while writing
+    PositionWriter* writer = create_position_writer(path, 2);
+    assert(writer != NULL);
+    for (int i = 0; i < 5; ++i) {
+        assert(pack_position(i % 2 == 0 ? board : ep_board, -i, 0, &packed));
+        assert(write_packed_position(writer, &packed));
+    }
+    assert(close_position_writer(writer));
+
+    PositionReader* reader = open_position_reader(path);
+    assert(reader != NULL);
+    assert(reader->count == 5);
+    assert(unpack_position(get_packed_position(reader, 3), unpacked, &score, &result));
+    assert(score == -3);
+    assert(unpacked->turn == BLACK_TURN);
+    assert(unpack_position(get_packed_position(reader, 4), unpacked, &score, &result));
+    assert(unpacked->turn == WHITE_TURN);
+    assert(!unpacked->en_passant);
+    close_position_reader(reader);
+    unlink(path);
+
+    destroy_board(unpacked);
+    destroy_board(ep_board);
+}
+
+
+void test_attacks(Board* board)
+{
+    // Set-wise attacks of a single piece match the per piece generators
+    uint64_t occupied = 0x00422C1000A41200ULL;
+    for (size_t square = 0; square < 64; ++square) {
+        uint64_t position = 1ULL << square;
+        uint64_t others = occupied & ~position;
+        assert(get_rooks_attacks(position, ~others) == get_pseudomoves_from_rook(position, 0ULL, others));
+        assert(get_bishops_attacks(position, ~others) == get_pseudomoves_from_bishop(position, 0ULL, others));
+        assert(get_kings_attacks(position) == get_pseudomoves_from_king(position, 0ULL));
+    }
+    // Knights on b1 and h8
+    assert(get_knights_attacks(get_square_position(1, 2)) == (get_square_position(3, 1) | get_square_position(3, 3) | get_square_position(2, 4)));
+    assert(get_knights_attacks(get_square_position(8, 8)) == (get_square_position(6, 7) | get_square_position(7, 6)));
+    assert(get_knights_attacks(get_square_position(4, 4)) == 0x0000284400442800ULL);
+    uint64_t rooks = 0x0000100000000081ULL;
+    assert(get_rooks_attacks(rooks, ~occupied) == (get_rooks_attacks(0x80ULL, ~occupied) | get_rooks_attacks(0x01ULL, ~occupied)
+                                                   | get_rooks_attacks(0x0000100000000000ULL, ~occupied)));
+
+    AttackMaps attack_maps;
+    compute_attack_maps(board, &attack_maps);
+    assert(attack_maps.white_attacks == 0x0000000000FFFF7EULL);
+    assert(attack_maps.black_attacks == 0x7EFFFF0000000000ULL);
+    assert((attack_maps.white_double_attacks & 0x0000000000FF0000ULL) == 0x0000000000FF0000ULL);
+    assert((attack_maps.black_double_attacks & 0x0000FF0000000000ULL) == 0x0000FF0000000000ULL);
+    assert(attack_maps.piece_attacks[W_PAWN_I] == 0x0000000000FF0000ULL);
+    assert(attack_maps.piece_attacks[W_QUEEN_I] == get_square_position(2, 3) + get_square_position(2, 4) + get_square_position(2, 5)
+                                                   + get_square_position(1, 3) + get_square_position(1, 5));
+    assert(!is_in_check(board));
+
+    // Fool's mate
+    Board* mated = create_board_from_fen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq -");
+    assert(mated != NULL);
+    assert(is_in_check(mated));
+    compute_attack_maps(mated, &attack_maps);
+    assert(is_king_attacked(mated, &attack_maps, WHITE_TURN));
+    assert(!is_king_attacked(mated, &attack_maps, BLACK_TURN));
+    assert(get_pawns_attacks(mated->pieces[W_PAWN_I], WHITE_TURN) == attack_maps.piece_attacks[W_PAWN_I]);
+    Board* boards[2] = { board, mated };
+    for (size_t i = 0; i < 2; ++i) {
+        compute_attack_maps(boards[i], &attack_maps);
+        for (size_t square = 0; square < 64; ++square) {
+            uint64_t position = 1ULL << square;
+            assert(is_square_attacked(boards[i], position, WHITE_TURN) == ((attack_maps.white_attacks & position) != 0ULL));
+            assert(is_square_attacked(boards[i], position, BLACK_TURN) == ((attack_maps.black_attacks & position) != 0ULL));
+        }
+    }
+    destroy_board(mated);
+}
+
+
 int main(void)
 {
     printf("Nothing more should be printed\n");
@@ -72,6 +567,15 @@ int main(void)
     test_get_occupied_squares(default_board);
     test_get_pieces_positions(default_board);
     test_is_piece_in();
+    test_create_board_from_fen(default_board);
+    test_book(default_board);
+    test_make_move(default_board);
+    test_search_board();
+    test_search_trace();
+    test_arena();
+    test_selfplay();
+    test_packed_positions(default_board);
+    test_attacks(default_board);
 
     destroy_board(default_board);
 